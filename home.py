@@ -1,3 +1,4 @@
+import os
 import streamlit as st
 import pandas as pd
 import seaborn as sns
@@ -7,6 +8,17 @@ import matplotlib.pyplot as plt
 sns.set_style("whitegrid")
 sns.set_palette("pastel")
 
+def carregar_resultado(nome):
+    # Usa o arquivo Arrow gerado pelo main.exe (memory map, sem parsing) quando ele existe
+    caminho_arrow = f"output/{nome}.arrow"
+    if os.path.exists(caminho_arrow):
+        try:
+            import pyarrow.feather as feather
+            return feather.read_table(caminho_arrow, memory_map=True).to_pandas()
+        except ImportError:
+            pass
+    return pd.read_csv(f"output/{nome}.csv")
+
 def plot_classificacao_contas(df):
     fig, ax = plt.subplots(figsize=(8, 5))
     sns.countplot(
@@ -183,11 +195,11 @@ st.markdown(
 if st.button("🔄 Refresh"):
     st.success("Dados atualizados!")
 
-    df_classificacao = pd.read_csv("output/classified_accounts.csv")
-    df_cidades = pd.read_csv("output/top_10_cities.csv")
-    df_transacoes = pd.read_csv("output/num_transactions.csv")
-    df_anormalidades = pd.read_csv("output/abnormal_transactions.csv")
-    df_summary = pd.read_csv("output/summary_stats.csv")
+    df_classificacao = carregar_resultado("classified_accounts")
+    df_cidades = carregar_resultado("top_10_cities")
+    df_transacoes = carregar_resultado("num_transactions")
+    df_anormalidades = carregar_resultado("abnormal_transactions")
+    df_summary = carregar_resultado("summary_stats")
     df_benchmarkingCSV = pd.read_csv("data/benchmarkingCSV.csv")
     df_benchmarkingDB = pd.read_csv("data/benchmarkingDB.csv")
 
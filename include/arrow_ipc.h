@@ -0,0 +1,32 @@
+#ifndef ARROW_IPC_H
+#define ARROW_IPC_H
+
+#include <string>
+#include "df.h"
+
+/*
+Escrita e leitura de DataFrames no formato de arquivo Arrow IPC (o mesmo do Feather V2),
+que pandas/pyarrow abrem com memory map, sem parsing.
+
+Tipos das colunas no Arrow:
+  int -> int32, float -> float32, bool -> bool, string -> utf8, date -> date32 (dias),
+  time -> time64 (µs), timestamp -> timestamp (µs, sem fuso), decimal -> decimal128(19, 2)
+Uma coluna com valores fora do seu tipo declarado é escrita como utf8 (valores formatados
+como no CSV). Os registros são divididos em record batches de ARROW_BATCH_ROWS linhas.
+
+A leitura aceita os tipos acima e também float64, utf8 grande, date64, unidades de
+tempo diferentes de µs e inteiros de 8 a 64 bits (convertidos para os tipos do DataFrame;
+inteiros e tempos fora do intervalo do tipo de destino fazem a leitura falhar). Valores
+nulos viram o valor padrão do tipo (0, 0.0, false ou ""), já que o DataFrame não tem
+nulos. Arquivos com dicionários, compressão ou tipos aninhados não são suportados.
+*/
+
+const size_t ARROW_BATCH_ROWS = 65536;
+
+// Escreve o DataFrame no arquivo (via arquivo temporário + rename); false em caso de erro
+bool writeArrow(const DataFrame& df, const string& filename);
+
+// Lê um arquivo Arrow IPC; retorna nullptr (com a mensagem em cerr) se ele não puder ser lido
+DataFrame* readArrow(const string& filename);
+
+#endif // ARROW_IPC_H
@@ -0,0 +1,215 @@
+#ifndef DATETIME_H
+#define DATETIME_H
+
+#include <string>
+#include <cstdint>
+#include <cstdio>
+
+using namespace std;
+
+// Funções de leitura e escrita de datas (YYYY-MM-DD) e horários (HH:MM:SS.ffffff)
+// direto sobre as strings, sem criar substrings nem usar stoi.
+// Nas colunas do DataFrame: "date" guarda dias desde 1970-01-01 (int), "time" guarda
+// microssegundos desde a meia-noite e "timestamp" microssegundos desde 1970-01-01 (long long).
+
+const long long MICROS_PER_SECOND = 1000000LL;
+const long long MICROS_PER_HOUR = 3600LL * MICROS_PER_SECOND;
+const long long MICROS_PER_DAY = 24LL * MICROS_PER_HOUR;
+
+// Divisão com arredondamento para baixo (datas anteriores a 1970 são negativas)
+inline long long floor_div(long long a, long long b) {
+    long long q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+inline bool parse_two_digits(const char* s, int& value) {
+    if (s[0] < '0' || s[0] > '9' || s[1] < '0' || s[1] > '9') return false;
+    value = (s[0] - '0') * 10 + (s[1] - '0');
+    return true;
+}
+
+// Lê hora, minuto e segundo de "HH:MM[:SS...]"
+inline bool parse_time_of_day(const string& text, int& hour, int& minute, int& second) {
+    if (text.size() < 5 || text[2] != ':') return false;
+    if (!parse_two_digits(text.data(), hour) || !parse_two_digits(text.data() + 3, minute)) return false;
+    second = 0;
+    if (text.size() >= 8 && text[5] == ':' && !parse_two_digits(text.data() + 6, second)) return false;
+    return hour < 24 && minute < 60 && second < 61;
+}
+
+// Lê "HH:MM:SS[.ffffff]" a partir de text[offset] como microssegundos desde a meia-noite
+inline bool parse_time_micros(const string& text, size_t offset, long long& micros) {
+    if (text.size() < offset + 8 || text[offset + 2] != ':' || text[offset + 5] != ':') return false;
+    int hour, minute, second;
+    const char* s = text.data() + offset;
+    if (!parse_two_digits(s, hour) || !parse_two_digits(s + 3, minute) || !parse_two_digits(s + 6, second)) return false;
+    if (hour > 23 || minute > 59 || second > 60) return false;
+
+    // Fração de segundo com até 6 dígitos
+    long long fraction = 0;
+    size_t pos = offset + 8;
+    if (pos < text.size() && text[pos] == '.') {
+        int digits = 0;
+        for (++pos; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos) {
+            if (digits < 6) {
+                fraction = fraction * 10 + (text[pos] - '0');
+                digits++;
+            }
+        }
+        for (; digits < 6; ++digits) fraction *= 10;
+    }
+    if (pos != text.size()) return false;
+
+    micros = (hour * 3600LL + minute * 60LL + second) * MICROS_PER_SECOND + fraction;
+    return true;
+}
+
+// Dias desde 1970-01-01 para uma data do calendário gregoriano (algoritmo de H. Hinnant)
+inline int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// Data do calendário para um número de dias desde 1970-01-01
+inline void civil_from_days(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2));
+}
+
+inline bool is_leap_year(int year) {
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+inline int days_in_month(int year, int month) {
+    static const int lengths[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && is_leap_year(year)) ? 29 : lengths[month - 1];
+}
+
+// Lê os 10 primeiros caracteres de text ("YYYY-MM-DD") como dias desde 1970-01-01,
+// sem olhar o que vem depois (usada por parse_timestamp)
+inline bool parse_date_prefix(const string& text, int64_t& days) {
+    if (text.size() < 10 || text[4] != '-' || text[7] != '-') return false;
+    int high, low, month, day;
+    if (!parse_two_digits(text.data(), high) || !parse_two_digits(text.data() + 2, low)) return false;
+    if (!parse_two_digits(text.data() + 5, month) || !parse_two_digits(text.data() + 8, day)) return false;
+    int year = high * 100 + low;
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month)) return false;
+    days = days_from_civil(year, month, day);
+    return true;
+}
+
+// Lê exatamente "YYYY-MM-DD" como dias desde 1970-01-01
+inline bool parse_date(const string& text, int64_t& days) {
+    return text.size() == 10 && parse_date_prefix(text, days);
+}
+
+// Lê "YYYY-MM-DD HH:MM:SS[.ffffff]" (ou com 'T' no lugar do espaço) como microssegundos desde 1970-01-01
+inline bool parse_timestamp(const string& text, long long& micros) {
+    int64_t days;
+    if (!parse_date_prefix(text, days)) return false;
+    long long timeOfDay = 0;
+    if (text.size() > 10) {
+        if (text[10] != ' ' && text[10] != 'T') return false;
+        if (!parse_time_micros(text, 11, timeOfDay)) return false;
+    }
+    micros = days * MICROS_PER_DAY + timeOfDay;
+    return true;
+}
+
+// Dia da semana (0 = domingo) de um número de dias desde 1970-01-01, que foi uma quinta-feira
+inline int weekday_from_days(int64_t days) {
+    return static_cast<int>(days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6);
+}
+
+// Acrescenta value (0 <= value < 10^width) com width dígitos, completando com zeros à esquerda
+inline void append_digits(string& out, long long value, int width) {
+    size_t end = out.size() + width;
+    out.resize(end);
+    for (int k = 1; k <= width; ++k, value /= 10) out[end - k] = static_cast<char>('0' + value % 10);
+}
+
+// Acrescenta dias desde 1970-01-01 como "YYYY-MM-DD" ao fim de out
+inline void append_date(string& out, int64_t days) {
+    int year, month, day;
+    civil_from_days(days, year, month, day);
+    if (year < 0 || year > 9999) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, day);
+        out += buffer;
+        return;
+    }
+    append_digits(out, year, 4);
+    out += '-';
+    append_digits(out, month, 2);
+    out += '-';
+    append_digits(out, day, 2);
+}
+
+// Acrescenta microssegundos desde a meia-noite como "HH:MM:SS.ffffff" ao fim de out
+inline void append_time(string& out, long long micros) {
+    micros = micros - floor_div(micros, MICROS_PER_DAY) * MICROS_PER_DAY;
+    long long seconds = micros / MICROS_PER_SECOND;
+    append_digits(out, seconds / 3600, 2);
+    out += ':';
+    append_digits(out, seconds / 60 % 60, 2);
+    out += ':';
+    append_digits(out, seconds % 60, 2);
+    out += '.';
+    append_digits(out, micros % MICROS_PER_SECOND, 6);
+}
+
+// Acrescenta microssegundos desde 1970-01-01 como "YYYY-MM-DD HH:MM:SS.ffffff" ao fim de out
+inline void append_timestamp(string& out, long long micros) {
+    long long days = floor_div(micros, MICROS_PER_DAY);
+    append_date(out, days);
+    out += ' ';
+    append_time(out, micros - days * MICROS_PER_DAY);
+}
+
+// Escreve dias desde 1970-01-01 como "YYYY-MM-DD"
+inline string format_date(int64_t days) {
+    string out;
+    append_date(out, days);
+    return out;
+}
+
+// Escreve microssegundos desde a meia-noite como "HH:MM:SS.ffffff"
+inline string format_time(long long micros) {
+    string out;
+    append_time(out, micros);
+    return out;
+}
+
+// Escreve microssegundos desde 1970-01-01 como "YYYY-MM-DD HH:MM:SS.ffffff"
+inline string format_timestamp(long long micros) {
+    string out;
+    append_timestamp(out, micros);
+    return out;
+}
+
+// Partes de um valor temporal: hora e minuto de um horário (microssegundos desde a
+// meia-noite ou desde 1970) e dia de um timestamp
+inline int hour_of(long long micros) {
+    return static_cast<int>((micros - floor_div(micros, MICROS_PER_DAY) * MICROS_PER_DAY) / MICROS_PER_HOUR);
+}
+
+inline int minute_of_day(long long micros) {
+    return static_cast<int>((micros - floor_div(micros, MICROS_PER_DAY) * MICROS_PER_DAY) / (60 * MICROS_PER_SECOND));
+}
+
+inline int day_of(long long timestampMicros) {
+    return static_cast<int>(floor_div(timestampMicros, MICROS_PER_DAY));
+}
+
+#endif // DATETIME_H
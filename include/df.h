@@ -7,13 +7,74 @@
 #include <unordered_map>
 #include <mutex>
 #include <thread>
-#include <deque>
 #include <fstream>
 #include <sstream>
 #include <memory>
+#include <atomic>
+#include <algorithm>
+#include <charconv>
+#include "datetime.h"
 
 using namespace std;
-using ElementType = variant<int, float, bool, string>; // Tipo genérico para os dados 
+using ElementType = variant<int, float, bool, string, long long>; // Tipo genérico para os dados (long long: time, timestamp e decimal)
+
+class ThreadPool;
+
+class Column {
+    /*
+    Buffer de valores de uma coluna com contagem de referências: cópias de Column (e de
+    DataFrame) compartilham o mesmo buffer, que é imutável depois de publicado. Toda
+    leitura (também por uma Column não const) é feita sem cópia; só as escritas explícitas
+    (set, mutableValues, push_back, ...) copiam antes um buffer compartilhado
+    (copy-on-write), então as demais cópias continuam vendo os valores antigos.
+    As escritas não são sincronizadas: no DataFrame elas só acontecem sob mutexDF
+    (addColumn, addRecord, consolidate). Resultados preenchidos em paralelo usam
+    DataFrameBuilder.
+    */
+    public:
+        Column() : buffer(make_shared<vector<ElementType>>()) {}
+        Column(vector<ElementType> values) : buffer(make_shared<vector<ElementType>>(move(values))) {}
+
+        // Leitura, sem cópia
+        const ElementType& operator[](size_t i) const { return (*buffer)[i]; }
+        size_t size() const { return buffer->size(); }
+        bool empty() const { return buffer->empty(); }
+        const ElementType* data() const { return buffer->data(); }
+        vector<ElementType>::const_iterator begin() const { return buffer->cbegin(); }
+        vector<ElementType>::const_iterator end() const { return buffer->cend(); }
+        const vector<ElementType>& values() const { return *buffer; }
+        operator const vector<ElementType>&() const { return *buffer; }
+
+        // Indica se o buffer é compartilhado com outra cópia
+        bool shared() const { return buffer.use_count() > 1; }
+
+        // Escrita: copia o buffer antes, se ele for compartilhado
+        void set(size_t i, ElementType value) { mutableValues()[i] = move(value); }
+        vector<ElementType>& mutableValues() {
+            if (shared()) buffer = make_shared<vector<ElementType>>(*buffer);
+            return *buffer;
+        }
+        void push_back(ElementType value) { mutableValues().push_back(move(value)); }
+        void resize(size_t n) { mutableValues().resize(n); }
+        void reserve(size_t n) {
+            // Um buffer compartilhado é copiado já com a capacidade pedida
+            if (shared()) {
+                auto copy = make_shared<vector<ElementType>>();
+                copy->reserve(max(n, buffer->size()));
+                copy->insert(copy->end(), buffer->begin(), buffer->end());
+                buffer = move(copy);
+            } else {
+                buffer->reserve(n);
+            }
+        }
+        void clear() {
+            if (shared()) buffer = make_shared<vector<ElementType>>();
+            else buffer->clear();
+        }
+
+    private:
+        shared_ptr<vector<ElementType>> buffer;
+};
 
 
 class DataFrame {
@@ -25,25 +86,57 @@ class DataFrame {
         DataFrame(const vector<string>& colNames, const vector<string>& colTypes);
         DataFrame(const DataFrame& other);
 
+        // Construtor e atribuição por movimento: transferem as colunas sem copiá-las e deixam
+        // o DataFrame de origem vazio
+        DataFrame(DataFrame&& other) noexcept;
+        DataFrame& operator=(DataFrame&& other) noexcept;
+        DataFrame& operator=(const DataFrame& other);
+
         // Destrutor
         ~DataFrame();
 
-        vector<vector<ElementType>> columns; 
+        // Colunas com buffers compartilhados entre cópias do DataFrame (copy-on-write).
+        // mutable: consolidate() (const) acrescenta a elas os blocos publicados
+        mutable vector<Column> columns; 
 
         // Metadados
-        int numRecords = 0; 
+        mutable int numRecords = 0; 
         int numCols = 0; 
         vector<string> colNames;
         unordered_map<string, int> idxColumns;
         unordered_map<string, string> colTypes;
 
         // Métodos
-        void addColumn(const vector<ElementType>& col, string colName, string colType);
+        // Uma Column vinda de outro DataFrame é adicionada sem cópia dos valores
+        void addColumn(Column col, string colName, string colType);
         void addRecord(const vector<string>& record);
         void addMultipleRecords(const vector<vector<string>>& records);
+
+        // Publica um bloco de colunas já convertidas (todas com o mesmo tamanho) sem travar o
+        // DataFrame; os registros ficam visíveis em columns após consolidate().
+        // sequence é a posição do bloco na fonte (ex.: a linha inicial no arquivo)
+        void appendChunk(vector<vector<ElementType>>&& chunkColumns, size_t sequence = UNORDERED_CHUNK);
+        void addMultipleRecords(const vector<vector<string>>& records, size_t sequence);
+
+        // Move os blocos publicados para columns em ordem de sequence (blocos sem sequência
+        // vão por último, na ordem de publicação), com uma única alocação por coluna.
+        // É const porque os registros publicados já pertencem ao DataFrame: a cópia e os
+        // getters (getNumRecords, getColumn, getRecord(s)) consolidam antes de ler
+        void consolidate() const;
+
+        static const size_t UNORDERED_CHUNK = static_cast<size_t>(-1);
+
+        // Novo DataFrame com as linhas indexes; com todas as linhas em ordem, compartilha as colunas
         DataFrame getRecords(const vector<int>& indexes) const;
         void printDF();
-        void DFtoCSV(string csvName);
+        // Escreve o DataFrame em csvName.csv; false se o arquivo não puder ser escrito
+        bool DFtoCSV(string csvName);
+
+        // Escrita paralela: tarefas do pool formatam blocos de CSV_BLOCK_ROWS linhas em buffers
+        // próprios, escritos no arquivo em ordem (mesma saída de DFtoCSV(csvName))
+        bool DFtoCSV(string csvName, int id, int numThreads, ThreadPool& pool);
+
+        static const size_t CSV_BLOCK_ROWS = 16384;
         
         // Retorna o registro (linha) i como vetor de ElementType
         vector<ElementType> getRecord(int i) const;
@@ -57,8 +150,8 @@ class DataFrame {
         // Retorna o número de colunas
         int getNumCols() const;
 
-        // Retorna a coluna i como vetor de ElementType
-        vector<ElementType> getColumn(int i) const;
+        // Retorna a coluna i, compartilhando o buffer (sem cópia dos valores)
+        Column getColumn(int i) const;
 
         // Retorna o mapa de tipos das colunas
         unordered_map<string, string> getColumnTypes() const;
@@ -75,13 +168,31 @@ class DataFrame {
         // Troca um nome de uma coluna específica
         void changeColumnName(string pastName, string newName);
 
+        // Versão dos dados e metadados: muda a cada alteração (registros, colunas ou nomes),
+        // então quem guardou a versão sabe se o DataFrame mudou desde então
+        unsigned long long getVersion() const { return version.load(memory_order_acquire); }
+
     private:
-        // Concorrência 
+        // Bloco publicado por appendChunk, encadeado em uma pilha lock-free
+        struct ColumnChunk {
+            vector<vector<ElementType>> columns;
+            size_t numRecords;
+            size_t sequence;
+            ColumnChunk* next;
+        };
+        mutable atomic<ColumnChunk*> stagedChunks{nullptr};
+        void freeStagedChunks();
+
+        // Concorrência: os blocos publicados são imutáveis até consolidate(), e as alterações
+        // de columns e dos metadados acontecem sob mutexDF, incrementando version
         mutable mutex mutexDF;
-        deque<mutex> columnMutexes;
-        deque<mutex> rowMutexes;
+        mutable atomic<unsigned long long> version{0};
 };
 
+// Handle de posse compartilhada: resultados passam entre etapas do pipeline e threads sem
+// cópia das colunas, e o DataFrame é liberado quando a última etapa deixa de usá-lo
+using DataFramePtr = shared_ptr<DataFrame>;
+
 inline string variantToString(const ElementType& val) {
     /*Função auxiliar para alterar o tipo variant para string.*/
     return visit([](const auto& arg) -> string {
@@ -92,5 +203,97 @@ inline string variantToString(const ElementType& val) {
     }, val);
 }
 
+// Colunas "decimal" guardam valores monetários como long long em centavos (somas exatas)
+const long long DECIMAL_SCALE = 100;
+
+inline void appendDecimal(string& out, long long cents) {
+    /*Acrescenta um valor em centavos como "123.45" ao fim de out.*/
+    unsigned long long magnitude = cents < 0 ? 0ULL - static_cast<unsigned long long>(cents) : static_cast<unsigned long long>(cents);
+    if (cents < 0) out += '-';
+    char buffer[24];
+    out.append(buffer, to_chars(buffer, buffer + sizeof(buffer), magnitude / DECIMAL_SCALE).ptr);
+    out += '.';
+    append_digits(out, magnitude % DECIMAL_SCALE, 2);
+}
+
+inline string formatDecimal(long long cents) {
+    /*Escreve um valor em centavos como "123.45".*/
+    string out;
+    appendDecimal(out, cents);
+    return out;
+}
+
+// Divisor que converte o long long de uma coluna no seu valor numérico (centavos -> reais em decimal)
+inline double numericDivisor(const string& type) {
+    return type == "decimal" ? static_cast<double>(DECIMAL_SCALE) : 1.0;
+}
+
+inline bool numericValue(const ElementType& val, double divisor, double& out) {
+    /*Lê um valor int, float ou long long (dividido por divisor) como double; false para os demais tipos.*/
+    if (const float* f = get_if<float>(&val)) out = *f;
+    else if (const int* i = get_if<int>(&val)) out = *i;
+    else if (const long long* l = get_if<long long>(&val)) out = *l / divisor;
+    else return false;
+    return true;
+}
+
+// Formato de escrita dos valores de uma coluna, resolvido uma vez a partir do tipo
+enum class ValueFormat { PLAIN, DATE, TIME, TIMESTAMP, DECIMAL };
+
+inline ValueFormat valueFormatFor(const string& type) {
+    if (type == "date") return ValueFormat::DATE;
+    if (type == "time") return ValueFormat::TIME;
+    if (type == "timestamp") return ValueFormat::TIMESTAMP;
+    if (type == "decimal") return ValueFormat::DECIMAL;
+    return ValueFormat::PLAIN;
+}
+
+inline void appendValue(string& out, const ElementType& val, ValueFormat format) {
+    /*
+    Acrescenta o valor formatado ao fim de out, sem strings temporárias. Números usam
+    to_chars (floats com 6 casas, como to_string) e datas/horários o formato de leitura.
+    */
+    char buffer[64];
+    switch (val.index()) {
+        case 0:
+            if (format == ValueFormat::DATE) return append_date(out, get<int>(val));
+            out.append(buffer, to_chars(buffer, buffer + sizeof(buffer), get<int>(val)).ptr);
+            return;
+        case 1: {
+            to_chars_result result = to_chars(buffer, buffer + sizeof(buffer), static_cast<double>(get<float>(val)), chars_format::fixed, 6);
+            if (result.ec == errc()) out.append(buffer, result.ptr);
+            else out += to_string(get<float>(val));
+            return;
+        }
+        case 2:
+            out += get<bool>(val) ? '1' : '0';
+            return;
+        case 3:
+            out += get<string>(val);
+            return;
+        default: {
+            long long value = get<long long>(val);
+            if (format == ValueFormat::TIME) return append_time(out, value);
+            if (format == ValueFormat::TIMESTAMP) return append_timestamp(out, value);
+            if (format == ValueFormat::DECIMAL) return appendDecimal(out, value);
+            out.append(buffer, to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+            return;
+        }
+    }
+}
+
+inline string formatValue(const ElementType& val, const string& type) {
+    /*Converte um valor para string de acordo com o tipo da coluna (datas e horários no formato de leitura).*/
+    string out;
+    appendValue(out, val, valueFormatFor(type));
+    return out;
+}
+
+// Lê "123.45" (até 2 casas; casas extras são arredondadas) em centavos, sem passar por float
+bool parseDecimal(const string& text, long long& cents);
+
+// Lê um valor de texto no tipo da coluna; lança invalid_argument se o texto não corresponder ao tipo
+ElementType parseValue(const string& value, const string& type);
+
 string variantToString(const ElementType& val);
 #endif
\ No newline at end of file
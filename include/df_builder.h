@@ -0,0 +1,84 @@
+#ifndef DF_BUILDER_H
+#define DF_BUILDER_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include "df.h"
+
+using namespace std;
+
+class ColumnBuilder {
+    /*
+    Coluna de um resultado em construção, com valores nativos (sem passar por string).
+    Com a coluna pré-dimensionada, várias tarefas podem escrever com set() ao mesmo tempo,
+    cada uma em posições distintas.
+    */
+    public:
+        ColumnBuilder(size_t numRecords = 0) : values(numRecords) {}
+
+        void set(size_t row, ElementType value) { values[row] = move(value); }
+        void push_back(ElementType value) { values.push_back(move(value)); }
+        void reserve(size_t n) { values.reserve(n); }
+        void resize(size_t n) { values.resize(n); }
+        size_t size() const { return values.size(); }
+
+        // Acrescenta os valores de um vetor já calculado (movidos, sem cópia de strings)
+        void append(vector<ElementType>&& other) {
+            if (values.empty()) {
+                values = move(other);
+                return;
+            }
+            values.insert(values.end(), make_move_iterator(other.begin()), make_move_iterator(other.end()));
+        }
+
+    private:
+        vector<ElementType> values;
+        friend class DataFrameBuilder;
+};
+
+class DataFrameBuilder {
+    /*
+    Monta o DataFrame de saída de um operador coluna a coluna: os operadores escrevem
+    valores nativos nas colunas (em paralelo, nas posições pré-dimensionadas, ou com
+    push_back) e finish() move as colunas para o DataFrame, sem cópia e sem o
+    formata/relê de addRecord.
+    */
+    public:
+        DataFrameBuilder(const vector<string>& colNames, const vector<string>& colTypes, size_t numRecords = 0)
+            : colNames(colNames), colTypes(colTypes), columns(colNames.size(), ColumnBuilder(numRecords)) {}
+
+        ColumnBuilder& column(size_t idxColumn) { return columns[idxColumn]; }
+        size_t getNumCols() const { return columns.size(); }
+
+        // Redimensiona todas as colunas para numRecords linhas
+        void resize(size_t numRecords) {
+            for (auto& column : columns) column.resize(numRecords);
+        }
+
+        // Move as colunas para um novo DataFrame; o builder fica vazio
+        DataFrame finish() {
+            size_t numRecords = columns.empty() ? 0 : columns[0].size();
+            for (auto& column : columns) {
+                if (column.size() != numRecords) {
+                    cerr << "Número de registros incompatível entre as colunas do resultado" << endl;
+                    column.resize(numRecords);
+                }
+            }
+
+            DataFrame result(colNames, colTypes);
+            for (size_t j = 0; j < columns.size(); ++j) {
+                result.columns[j] = Column(move(columns[j].values));
+            }
+            result.numRecords = numRecords;
+            columns.assign(columns.size(), ColumnBuilder());
+            return result;
+        }
+
+    private:
+        vector<string> colNames;
+        vector<string> colTypes;
+        vector<ColumnBuilder> columns;
+};
+
+#endif // DF_BUILDER_H
@@ -0,0 +1,153 @@
+#ifndef DF_VIEW_H
+#define DF_VIEW_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include "df.h"
+
+using namespace std;
+
+// Coluna lida através de uma view: a posição i corresponde à linha rows[i] do DataFrame
+// original, ou à linha i quando não há seleção. Não copia os valores.
+class ColumnRef {
+    public:
+        ColumnRef(const vector<ElementType>& column) : values(column.data()), rows(nullptr), n(column.size()) {}
+        ColumnRef(const Column& column) : values(column.data()), rows(nullptr), n(column.size()) {}
+        ColumnRef(const ElementType* values, const size_t* rows, size_t n) : values(values), rows(rows), n(n) {}
+
+        const ElementType& operator[](size_t i) const { return rows ? values[rows[i]] : values[i]; }
+        size_t size() const { return n; }
+
+        // Valores contíguos (sem seleção): data() aponta para a posição 0
+        bool contiguous() const { return rows == nullptr; }
+        const ElementType* data() const { return values; }
+
+        // Trecho [start, start + len) da coluna
+        ColumnRef slice(size_t start, size_t len) const {
+            return rows ? ColumnRef(values, rows + start, len) : ColumnRef(values + start, nullptr, len);
+        }
+
+    private:
+        const ElementType* values;
+        const size_t* rows;
+        size_t n;
+};
+
+class DataFrameView {
+    /*
+    Visão de um DataFrame sem cópia dos dados: referencia as colunas do DataFrame
+    original, com uma seleção opcional de linhas (índices no original, na ordem da
+    view) e uma projeção opcional de colunas. Filtros sobre a view só produzem uma
+    nova seleção, então filtro -> groupby -> ordenação lêem os dados base uma única vez;
+    os dados só são copiados ao materializar (materialize / gather_rows).
+    O DataFrame original precisa continuar vivo e sem alterações enquanto a view existir
+    (stale() indica se ele mudou desde que a view foi criada).
+    Um DataFrame é convertido implicitamente em uma view com todas as linhas e colunas.
+    Views de DataFrames temporários não compilam, já que o temporário morreria antes da view.
+    */
+    public:
+        DataFrameView(const DataFrame& df) : df(&df), version(consolidatedVersion(df)) {}
+        DataFrameView(DataFrame&&) = delete;
+
+        // View com as linhas rows do DataFrame original
+        DataFrameView(const DataFrame& df, vector<size_t> rows)
+            : df(&df), version(consolidatedVersion(df)), selection(make_shared<const vector<size_t>>(move(rows))) {}
+        DataFrameView(DataFrame&&, vector<size_t>) = delete;
+
+        // Retorna o número de registros (linhas) da view
+        int getNumRecords() const {
+            return selection ? static_cast<int>(selection->size()) : df->getNumRecords();
+        }
+
+        // Retorna o número de colunas da view
+        int getNumCols() const {
+            return projection.empty() ? df->getNumCols() : static_cast<int>(projection.size());
+        }
+
+        // Retorna os nomes das colunas
+        vector<string> getColumnNames() const {
+            vector<string> names;
+            for (int j = 0; j < getNumCols(); ++j) names.push_back(getColumnName(j));
+            return names;
+        }
+
+        // Retorna o nome de uma coluna
+        string getColumnName(int idxColumn) const {
+            return df->getColumnName(baseColumn(idxColumn));
+        }
+
+        // Retorna o tipo de uma coluna
+        string getColumnType(int idxColumn) const {
+            return df->getColumnType(baseColumn(idxColumn));
+        }
+
+        // Retorna o índice da coluna na view; lança invalid_argument se ela não estiver na view
+        int getColumnIndex(const string& colName) const {
+            auto it = df->idxColumns.find(colName);
+            if (it != df->idxColumns.end()) {
+                if (projection.empty()) return it->second;
+                for (size_t j = 0; j < projection.size(); ++j) {
+                    if (projection[j] == it->second) return static_cast<int>(j);
+                }
+            }
+            throw invalid_argument("Coluna '" + colName + "' não encontrada.");
+        }
+
+        // Coluna idxColumn da view, sem cópia
+        ColumnRef getColumn(int idxColumn) const {
+            const Column& column = df->columns[baseColumn(idxColumn)];
+            if (!selection) return ColumnRef(column);
+            return ColumnRef(column.data(), selection->data(), selection->size());
+        }
+
+        ColumnRef getColumn(const string& colName) const {
+            return getColumn(getColumnIndex(colName));
+        }
+
+        // Linha do DataFrame original que ocupa a posição i da view
+        size_t baseRow(size_t i) const { return selection ? (*selection)[i] : i; }
+
+        // Índice no DataFrame original da coluna idxColumn da view
+        int baseColumn(int idxColumn) const { return projection.empty() ? idxColumn : projection[idxColumn]; }
+
+        // Indica se o DataFrame original foi alterado depois da criação da view
+        bool stale() const { return df->getVersion() != version; }
+
+        bool hasSelection() const { return selection != nullptr; }
+        const DataFrame& base() const { return *df; }
+
+        // Nova view só com as colunas pedidas, na ordem dada
+        DataFrameView select(const vector<string>& colNames) const {
+            vector<int> columns;
+            for (const string& name : colNames) columns.push_back(baseColumn(getColumnIndex(name)));
+            DataFrameView view(*this);
+            view.projection = move(columns);
+            return view;
+        }
+
+        // Nova view com as posições (desta view) dadas, na ordem dada
+        DataFrameView take(const vector<size_t>& positions) const {
+            vector<size_t> rows(positions.size());
+            for (size_t i = 0; i < positions.size(); ++i) rows[i] = baseRow(positions[i]);
+            DataFrameView view(*df, move(rows));
+            view.projection = projection;
+            view.version = version;
+            return view;
+        }
+
+    private:
+        // Registros publicados e ainda não consolidados passam a fazer parte da view
+        static unsigned long long consolidatedVersion(const DataFrame& df) {
+            df.consolidate();
+            return df.getVersion();
+        }
+
+        const DataFrame* df;
+        unsigned long long version;                   // versão do DataFrame na criação da view
+        shared_ptr<const vector<size_t>> selection;   // nullptr: todas as linhas
+        vector<int> projection;                       // vazio: todas as colunas
+};
+
+#endif // DF_VIEW_H
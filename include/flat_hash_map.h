@@ -0,0 +1,170 @@
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <functional>
+
+using namespace std;
+
+// Mistura os bits de um hash (std::hash<int> é a identidade, o que seria ruim com máscara)
+inline uint64_t mix_hash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Tabela hash de endereçamento aberto (sondagem linear) usada pelos tratadores.
+// As chaves e valores ficam em um único vetor contíguo e um vetor paralelo de bytes
+// de controle guarda 7 bits do hash de cada posição ocupada, de modo que a maioria
+// das comparações de chave durante a sondagem é evitada.
+template <typename K, typename V, typename Hash = hash<K>, typename Eq = equal_to<K>>
+class FlatHashMap {
+    public:
+        struct Slot {
+            K first;
+            V second;
+        };
+
+        FlatHashMap() = default;
+
+        explicit FlatHashMap(size_t expectedSize) {
+            reserve(expectedSize);
+        }
+
+        // Garante capacidade para expectedSize chaves sem redimensionar
+        void reserve(size_t expectedSize) {
+            size_t needed = capacityFor(expectedSize);
+            if (needed > ctrl.size()) rehash(needed);
+        }
+
+        // Retorna o valor da chave, inserindo um valor padrão se ela não existir
+        V& operator[](const K& key) {
+            return findOrInsert(key)->second;
+        }
+
+        // Retorna ponteiro para o valor da chave ou nullptr se ela não existir
+        V* find(const K& key) {
+            Slot* slot = lookup(key);
+            return slot ? &slot->second : nullptr;
+        }
+
+        const V* find(const K& key) const {
+            const Slot* slot = const_cast<FlatHashMap*>(this)->lookup(key);
+            return slot ? &slot->second : nullptr;
+        }
+
+        size_t size() const { return numElements; }
+        bool empty() const { return numElements == 0; }
+        size_t capacity() const { return ctrl.size(); }
+
+        void clear() {
+            ctrl.clear();
+            slots.clear();
+            numElements = 0;
+        }
+
+        // Iterador sobre as posições ocupadas
+        template <typename SlotType, typename MapType>
+        class Iterator {
+            public:
+                Iterator(MapType* m, size_t p) : map(m), pos(p) { skipEmpty(); }
+                SlotType& operator*() const { return map->slots[pos]; }
+                SlotType* operator->() const { return &map->slots[pos]; }
+                Iterator& operator++() { ++pos; skipEmpty(); return *this; }
+                bool operator!=(const Iterator& other) const { return pos != other.pos; }
+                bool operator==(const Iterator& other) const { return pos == other.pos; }
+
+            private:
+                void skipEmpty() {
+                    while (pos < map->ctrl.size() && map->ctrl[pos] == EMPTY) ++pos;
+                }
+                MapType* map;
+                size_t pos;
+        };
+
+        using iterator = Iterator<Slot, FlatHashMap>;
+        using const_iterator = Iterator<const Slot, const FlatHashMap>;
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, ctrl.size()); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, ctrl.size()); }
+
+    private:
+        static constexpr uint8_t EMPTY = 0;
+        static constexpr size_t MIN_CAPACITY = 16;
+
+        vector<uint8_t> ctrl;   // 0 = vazio, 0x80 | 7 bits do hash = ocupado
+        vector<Slot> slots;
+        size_t numElements = 0;
+        Hash hasher;
+        Eq equal;
+
+        // Menor potência de dois que mantém a ocupação abaixo de 75%
+        static size_t capacityFor(size_t numKeys) {
+            size_t capacity = MIN_CAPACITY;
+            while (capacity * 3 / 4 < numKeys) capacity <<= 1;
+            return capacity;
+        }
+
+        static uint8_t tagOf(uint64_t h) {
+            return static_cast<uint8_t>(0x80 | (h & 0x7F));
+        }
+
+        Slot* lookup(const K& key) {
+            if (ctrl.empty()) return nullptr;
+            uint64_t h = mix_hash(hasher(key));
+            uint8_t tag = tagOf(h);
+            size_t mask = ctrl.size() - 1;
+            for (size_t pos = (h >> 7) & mask; ; pos = (pos + 1) & mask) {
+                if (ctrl[pos] == EMPTY) return nullptr;
+                if (ctrl[pos] == tag && equal(slots[pos].first, key)) return &slots[pos];
+            }
+        }
+
+        Slot* findOrInsert(const K& key) {
+            if (ctrl.empty() || (numElements + 1) > ctrl.size() * 3 / 4) {
+                rehash(ctrl.empty() ? MIN_CAPACITY : ctrl.size() * 2);
+            }
+            uint64_t h = mix_hash(hasher(key));
+            uint8_t tag = tagOf(h);
+            size_t mask = ctrl.size() - 1;
+            for (size_t pos = (h >> 7) & mask; ; pos = (pos + 1) & mask) {
+                if (ctrl[pos] == EMPTY) {
+                    ctrl[pos] = tag;
+                    slots[pos].first = key;
+                    slots[pos].second = V();
+                    numElements++;
+                    return &slots[pos];
+                }
+                if (ctrl[pos] == tag && equal(slots[pos].first, key)) return &slots[pos];
+            }
+        }
+
+        void rehash(size_t newCapacity) {
+            vector<uint8_t> oldCtrl = move(ctrl);
+            vector<Slot> oldSlots = move(slots);
+
+            ctrl.assign(newCapacity, EMPTY);
+            slots.clear();
+            slots.resize(newCapacity);
+            size_t mask = newCapacity - 1;
+
+            for (size_t i = 0; i < oldCtrl.size(); ++i) {
+                if (oldCtrl[i] == EMPTY) continue;
+                uint64_t h = mix_hash(hasher(oldSlots[i].first));
+                size_t pos = (h >> 7) & mask;
+                while (ctrl[pos] != EMPTY) pos = (pos + 1) & mask;
+                ctrl[pos] = oldCtrl[i];
+                slots[pos] = move(oldSlots[i]);
+            }
+        }
+};
+
+#endif // FLAT_HASH_MAP_H
@@ -0,0 +1,65 @@
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+// Precisão padrão: 2^12 registradores (4 KB), erro padrão em torno de 1,6%
+const int HLL_DEFAULT_PRECISION = 12;
+
+// Sketch HyperLogLog para contar valores distintos de forma aproximada.
+// Recebe hashes de 64 bits já misturados (ex.: mix_hash de flat_hash_map.h) e usa
+// 2^precision registradores de um byte. Dois sketches de mesma precisão são fundidos
+// pelo máximo de cada registrador, então cada thread pode resumir o seu bloco.
+class HyperLogLog {
+    public:
+        explicit HyperLogLog(int precision = HLL_DEFAULT_PRECISION)
+            : precision(std::min(std::max(precision, 4), 18)), registers(size_t(1) << this->precision, 0) {}
+
+        // Registra o hash de um valor
+        void add(uint64_t hash) {
+            size_t index = hash >> (64 - precision);
+            // Bit de guarda garante que a contagem de zeros à esquerda termina
+            uint64_t rest = (hash << precision) | (uint64_t(1) << (precision - 1));
+            uint8_t rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+            if (rank > registers[index]) registers[index] = rank;
+        }
+
+        // Incorpora outro sketch de mesma precisão
+        void merge(const HyperLogLog& other) {
+            if (other.precision != precision) return;
+            for (size_t i = 0; i < registers.size(); ++i) {
+                registers[i] = std::max(registers[i], other.registers[i]);
+            }
+        }
+
+        // Estimativa do número de valores distintos
+        double estimate() const {
+            double m = static_cast<double>(registers.size());
+            double sum = 0.0;
+            size_t zeros = 0;
+            for (uint8_t r : registers) {
+                sum += ldexp(1.0, -r);
+                if (r == 0) zeros++;
+            }
+
+            double alpha = 0.7213 / (1.0 + 1.079 / m);
+            double raw = alpha * m * m / sum;
+
+            // Correção para cardinalidades pequenas (contagem linear)
+            if (raw <= 2.5 * m && zeros > 0) return m * log(m / zeros);
+            return raw;
+        }
+
+        int getPrecision() const { return precision; }
+
+    private:
+        int precision;
+        vector<uint8_t> registers;
+};
+
+#endif // HYPERLOGLOG_H
@@ -0,0 +1,104 @@
+#ifndef PREDICATE_H
+#define PREDICATE_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <variant>
+#include <type_traits>
+#include "df.h"
+
+using namespace std;
+
+// Literal de um predicado: inteiro, real, bool ou texto. Guardar reais como double
+// evita perder precisão (ex.: 500.01 em uma coluna decimal).
+struct Literal {
+    variant<long long, double, bool, string> value;
+
+    Literal(int v) : value(static_cast<long long>(v)) {}
+    Literal(long long v) : value(v) {}
+    Literal(float v) : value(static_cast<double>(v)) {}
+    Literal(double v) : value(v) {}
+    Literal(bool v) : value(v) {}
+    Literal(const char* v) : value(string(v)) {}
+    Literal(const string& v) : value(v) {}
+    Literal(const ElementType& v) {
+        visit([this](const auto& arg) {
+            using T = decay_t<decltype(arg)>;
+            if constexpr (is_same_v<T, int>) value = static_cast<long long>(arg);
+            else if constexpr (is_same_v<T, float>) value = static_cast<double>(arg);
+            else value = arg;
+        }, v);
+    }
+};
+
+// Predicado sobre colunas de um DataFrame, avaliado por filter_where / select_rows.
+// Folhas comparam uma coluna com literais (comparação, faixa inclusiva ou lista IN) e
+// nós internos combinam os filhos com AND, OR e NOT. Literais string em colunas de
+// outros tipos são lidos no tipo da coluna (ex.: "2025-01-01" em uma coluna date,
+// "500.00" em uma coluna decimal); literais numéricos em colunas decimal estão em reais.
+// Valores de outro tipo que o da coluna (nulos) não são comparáveis: a folha não é
+// verdadeira nem falsa para eles, e a linha continua fora do resultado sob NOT (lógica de
+// três valores, como NULL em SQL).
+//
+// Exemplo: Predicate::compare("amount", Predicate::GT, 500) && Predicate::compare("location", Predicate::EQ, "Recife")
+struct Predicate {
+    enum Kind { COMPARE, BETWEEN, IN_LIST, AND, OR, NOT };
+    enum Op { EQ, NE, LT, LE, GT, GE };
+
+    Kind kind = COMPARE;
+    Op op = EQ;
+    string column;
+    vector<Literal> values;          // COMPARE: 1 literal, BETWEEN: [mínimo, máximo], IN_LIST: n literais
+    vector<Predicate> children;      // AND, OR: 2 filhos, NOT: 1 filho
+
+    static Predicate compare(const string& column, Op op, const Literal& value) {
+        Predicate p;
+        p.kind = COMPARE;
+        p.op = op;
+        p.column = column;
+        p.values = {value};
+        return p;
+    }
+
+    static Predicate between(const string& column, const Literal& low, const Literal& high) {
+        Predicate p;
+        p.kind = BETWEEN;
+        p.column = column;
+        p.values = {low, high};
+        return p;
+    }
+
+    static Predicate in_list(const string& column, const vector<Literal>& values) {
+        Predicate p;
+        p.kind = IN_LIST;
+        p.column = column;
+        p.values = values;
+        return p;
+    }
+};
+
+inline Predicate operator&&(Predicate left, Predicate right) {
+    Predicate p;
+    p.kind = Predicate::AND;
+    p.children.push_back(move(left));
+    p.children.push_back(move(right));
+    return p;
+}
+
+inline Predicate operator||(Predicate left, Predicate right) {
+    Predicate p;
+    p.kind = Predicate::OR;
+    p.children.push_back(move(left));
+    p.children.push_back(move(right));
+    return p;
+}
+
+inline Predicate operator!(Predicate child) {
+    Predicate p;
+    p.kind = Predicate::NOT;
+    p.children.push_back(move(child));
+    return p;
+}
+
+#endif // PREDICATE_H
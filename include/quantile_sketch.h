@@ -0,0 +1,151 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+using namespace std;
+
+// Parâmetro k padrão do KLL: erro de posição em torno de 1,7 / k (~1% para k = 200)
+const int KLL_DEFAULT_K = 200;
+
+// Sketch de quantis aproximados KLL (Karnin, Lang e Liberty).
+// Usa memória O(k log(n / k)), aceita inserções uma a uma (update) e a fusão de
+// sketches construídos separadamente (merge), então cada thread pode montar o sketch
+// do seu bloco e os resultados são combinados no final, ou o sketch pode ser mantido
+// e atualizado conforme novas transações chegam.
+class KLLSketch {
+    public:
+        explicit KLLSketch(int k = KLL_DEFAULT_K) : k(std::max(k, 8)) {}
+
+        // Insere um valor
+        void update(double value) {
+            if (compactors.empty()) addLevel();
+            compactors[0].push_back(value);
+            numRetained++;
+            count++;
+            minValue = std::min(minValue, value);
+            maxValue = std::max(maxValue, value);
+            if (numRetained >= maxRetained) compress();
+        }
+
+        // Incorpora os valores resumidos por outro sketch
+        void merge(const KLLSketch& other) {
+            if (other.count == 0) return;
+            while (compactors.size() < other.compactors.size()) addLevel();
+            for (size_t h = 0; h < other.compactors.size(); ++h) {
+                compactors[h].insert(compactors[h].end(), other.compactors[h].begin(), other.compactors[h].end());
+            }
+            numRetained += other.numRetained;
+            count += other.count;
+            minValue = std::min(minValue, other.minValue);
+            maxValue = std::max(maxValue, other.maxValue);
+            while (numRetained >= maxRetained) compress();
+        }
+
+        // Valor aproximado do quantil q (0 <= q <= 1); mínimo e máximo são exatos
+        double quantile(double q) const {
+            return quantiles({q})[0];
+        }
+
+        vector<double> quantiles(const vector<double>& qs) const {
+            vector<double> result(qs.size(), 0.0);
+            if (count == 0) return result;
+
+            // Valores retidos com peso 2^nível, em ordem crescente
+            vector<pair<double, uint64_t>> weighted;
+            weighted.reserve(numRetained);
+            for (size_t h = 0; h < compactors.size(); ++h) {
+                for (double value : compactors[h]) weighted.emplace_back(value, uint64_t(1) << h);
+            }
+            sort(weighted.begin(), weighted.end());
+
+            for (size_t i = 0; i < qs.size(); ++i) {
+                if (qs[i] <= 0.0) { result[i] = minValue; continue; }
+                if (qs[i] >= 1.0) { result[i] = maxValue; continue; }
+
+                double target = qs[i] * count;
+                uint64_t cumulative = 0;
+                result[i] = weighted.back().first;
+                for (const auto& [value, weight] : weighted) {
+                    cumulative += weight;
+                    if (cumulative >= target) {
+                        result[i] = value;
+                        break;
+                    }
+                }
+            }
+            return result;
+        }
+
+        uint64_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        double min() const { return minValue; }
+        double max() const { return maxValue; }
+        size_t retained() const { return numRetained; }
+
+    private:
+        int k;
+        uint64_t count = 0;
+        size_t numRetained = 0;
+        double minValue = numeric_limits<double>::infinity();
+        double maxValue = -numeric_limits<double>::infinity();
+        vector<vector<double>> compactors;   // compactors[h] guarda valores com peso 2^h
+        vector<size_t> capacities;           // capacidade de cada nível, recalculada ao criar um nível
+        size_t maxRetained = 0;              // soma das capacidades
+        uint64_t coinState = 0x9E3779B97F4A7C15ULL;
+
+        // Cria um nível novo. A capacidade do nível h é k no mais alto e decai por 2/3 a cada
+        // nível abaixo, então todas são recalculadas
+        void addLevel() {
+            compactors.emplace_back();
+            capacities.resize(compactors.size());
+            maxRetained = 0;
+            for (size_t h = 0; h < compactors.size(); ++h) {
+                size_t depth = compactors.size() - h - 1;
+                size_t cap = static_cast<size_t>(ceil(k * pow(2.0 / 3.0, static_cast<double>(depth))));
+                capacities[h] = std::max<size_t>(cap, 2);
+                maxRetained += capacities[h];
+            }
+        }
+
+        // Moeda determinística (xorshift) para escolher quais elementos sobem de nível
+        bool flipCoin() {
+            coinState ^= coinState << 13;
+            coinState ^= coinState >> 7;
+            coinState ^= coinState << 17;
+            return coinState & 1;
+        }
+
+        // Compacta o primeiro nível acima da capacidade: ordena, promove metade dos
+        // elementos (posições pares ou ímpares) ao nível seguinte e descarta a outra metade
+        void compress() {
+            for (size_t h = 0; h < compactors.size(); ++h) {
+                if (compactors[h].size() < capacities[h]) continue;
+                if (h + 1 == compactors.size()) addLevel();
+
+                vector<double>& level = compactors[h];
+                sort(level.begin(), level.end());
+
+                // Com tamanho ímpar, o maior elemento fica neste nível
+                size_t pairs = level.size() / 2;
+                double leftover = level.back();
+                bool hasLeftover = level.size() % 2 == 1;
+
+                size_t offset = flipCoin() ? 1 : 0;
+                vector<double>& next = compactors[h + 1];
+                for (size_t i = offset; i < 2 * pairs; i += 2) next.push_back(level[i]);
+
+                level.clear();
+                if (hasLeftover) level.push_back(leftover);
+                numRetained -= pairs;
+                return;
+            }
+        }
+};
+
+#endif // QUANTILE_SKETCH_H
@@ -0,0 +1,79 @@
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+
+#include <string>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "df.h"
+#include "threads.h"
+
+using namespace std;
+
+// Formatos em que um resultado é salvo (combináveis com |)
+enum SinkFormat {
+    SINK_CSV = 1,         // <basePath>.csv (DFtoCSV, formatado em paralelo pelo pool)
+    SINK_SNAPSHOT = 2,    // <basePath>.dfsnap (snapshot.h)
+    SINK_ARROW = 4        // <basePath>.arrow (arrow_ipc.h)
+};
+
+// Limite padrão de células (registros x colunas) aguardando escrita
+const size_t SINK_DEFAULT_MAX_PENDING_CELLS = 1 << 24;
+
+// Etapa final do pipeline: os resultados prontos são entregues a uma thread de escrita
+// própria, e a escrita em disco acontece enquanto as próximas análises são calculadas.
+// A thread de escrita não é um worker do pool (que pode estar ocupado com operadores
+// esperando as suas sub-tarefas); ela só enfileira no pool os blocos do CSV.
+// A memória em voo é limitada: submit() bloqueia enquanto as células pendentes passam de
+// maxPendingCells (um resultado maior que o limite é aceito quando a fila está vazia).
+class ResultSink {
+    public:
+        ResultSink(int id, int numThreads, ThreadPool& pool, size_t maxPendingCells = SINK_DEFAULT_MAX_PENDING_CELLS);
+
+        // Espera as escritas pendentes e encerra a thread de escrita
+        ~ResultSink();
+
+        ResultSink(const ResultSink&) = delete;
+        ResultSink& operator=(const ResultSink&) = delete;
+
+        // Enfileira o resultado para escrita; o DataFrame é copiado compartilhando as colunas
+        // (copy-on-write), então quem chamou pode continuar usando e alterando o seu
+        void submit(const DataFrame& df, const string& basePath, int formats = SINK_CSV);
+        void submit(DataFramePtr df, const string& basePath, int formats = SINK_CSV);
+
+        // Bloqueia até que todos os resultados enfileirados tenham sido escritos
+        void flush();
+
+        // Número de arquivos que não puderam ser escritos
+        size_t getFailures() const { return failures.load(); }
+
+    private:
+        struct Job {
+            DataFramePtr df;
+            string basePath;
+            int formats;
+            size_t cells;
+        };
+
+        void run();
+        void write(Job& job);
+
+        int id;
+        int numThreads;
+        ThreadPool& pool;
+        size_t maxPendingCells;
+
+        queue<Job> jobs;
+        size_t pendingCells = 0;        // Células enfileiradas ou em escrita
+        bool writing = false;
+        bool stop = false;
+        mutex mtx;
+        condition_variable jobReady;    // Há resultado na fila (ou parada)
+        condition_variable spaceFreed;  // Uma escrita terminou
+        atomic<size_t> failures{0};
+        thread writer;                  // Iniciada por último, com os demais membros prontos
+};
+
+#endif // RESULT_SINK_H
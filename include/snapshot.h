@@ -0,0 +1,34 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include "df.h"
+
+/*
+Formato binário colunar de um DataFrame (snapshot), lido sem nenhuma conversão de texto.
+
+Layout do arquivo (inteiros na ordem de bytes da máquina, marcada no cabeçalho):
+  cabeçalho  magic "DFSNAP\0\1", versão (u32), marca de ordem de bytes (u32),
+             número de registros (u64), número de colunas (u32), tamanho do esquema (u32)
+  esquema    por coluna: codificação (u8), nome e tipo (u32 tamanho + bytes),
+             deslocamento, tamanho e checksum do buffer da coluna (u64 cada)
+             seguido do checksum do cabeçalho + esquema (u64)
+  dados      um buffer por coluna, alinhado em 8 bytes:
+             int/date -> int32[n], float -> float32[n], bool -> u8[n],
+             time/timestamp/decimal -> int64[n],
+             string -> dicionário: número de strings distintas (u64), códigos u32[n],
+                       deslocamentos u64[d + 1] e o blob com as strings concatenadas
+             colunas com valores de vários tipos -> tag u8[n], payload int64[n] e uma
+                       tabela de strings (mesmo layout do dicionário, sem códigos)
+
+A leitura mapeia o arquivo em memória (mmap; leitura comum no Windows), confere os
+checksums e decodifica os buffers tipados direto nas colunas.
+*/
+
+// Escreve o DataFrame no arquivo (via arquivo temporário + rename); false em caso de erro
+bool writeSnapshot(const DataFrame& df, const string& filename);
+
+// Lê um snapshot; retorna nullptr (com a mensagem em cerr) se o arquivo não existir ou estiver corrompido
+DataFrame* readSnapshot(const string& filename);
+
+#endif // SNAPSHOT_H
@@ -6,9 +6,42 @@
 #include <functional>
 #include <string>
 #include "df.h"
+#include "df_view.h"
+#include "df_builder.h"
 #include "threads.h"
+#include "quantile_sketch.h"
+#include "predicate.h"
 using namespace std;
 
+// Faixa [minKey, maxKey] de uma coluna de inteiros; dense indica se cabe em vetores indexados pela chave
+struct DenseKeyRange {
+    bool dense = false;
+    int minKey = 0;
+    int maxKey = -1;
+    size_t size() const { return dense ? static_cast<size_t>(maxKey - minKey) + 1 : 0; }
+};
+
+// Unidade dos baldes de time_histogram
+enum TimeUnit {
+    HOUR,
+    MINUTE,
+    DAY,
+    WEEKDAY
+};
+
+// Estatísticas de uma coluna numérica calculadas por summarize_columns
+struct ColumnSummary {
+    string column;
+    bool isInt = false;
+    size_t count = 0;           // valores numéricos
+    size_t nullCount = 0;       // valores não numéricos
+    double mean = 0.0;
+    double variance = 0.0;      // variância amostral
+    double min = 0.0;
+    double max = 0.0;
+    vector<double> quantiles;   // na ordem dos quantis pedidos
+};
+
 vector<int> filter_block_records(const class DataFrame& df, function<bool(const vector<ElementType>&)> condition, int idx_min, int idx_max);
 
 class DataFrame filter_records_by_idxes(const class DataFrame& df, const vector<int>& idxes);
@@ -16,17 +49,38 @@ class DataFrame filter_records_by_idxes(const class DataFrame& df, const vector<
 vector<int> filter_block_records(DataFrame& df, int id, int numThreads, function<bool(const vector<ElementType>&)> condition, int idxMin, int idxMax);
 DataFrame filter_records_by_idxes(DataFrame& df, int id, int numThreads, const vector<int>& idxes);
 DataFrame filter_records(DataFrame& df, int id, int numThreads, function<bool(const vector<ElementType>&)> condition, ThreadPool& pool);
-DataFrame groupby_mean(DataFrame& df, int id, int numThreads, const string& groupCol, const string& targetCol, ThreadPool& pool);
+vector<size_t> select_rows(const DataFrameView& df, int id, int numThreads, const Predicate& predicate, ThreadPool& pool);
+DataFrame filter_where(const DataFrameView& df, int id, int numThreads, const Predicate& predicate, ThreadPool& pool);
+DataFrameView filter_view(const DataFrameView& df, int id, int numThreads, const Predicate& predicate, ThreadPool& pool);
+size_t estimate_distinct(ColumnRef column, size_t start, size_t end);
+DenseKeyRange dense_key_range(ColumnRef column, int id, int numThreads, ThreadPool& pool);
+DataFrame groupby_mean(const DataFrameView& df, int id, int numThreads, const string& groupCol, const string& targetCol, ThreadPool& pool);
 DataFrame join_by_key(const DataFrame& df1, const DataFrame& df2, int id, int numThreads, const string& keyCol, ThreadPool& pool);
-DataFrame count_values(const DataFrame& df, int id, int numThreads, const string& colName, int numDays, ThreadPool& pool);
+DataFrame count_values(const DataFrameView& df, int id, int numThreads, const string& colName, int numDays, ThreadPool& pool);
+size_t count_distinct(const DataFrameView& df, int id, int numThreads, const string& colName, ThreadPool& pool, bool approximate = false);
+DataFrame count_distinct_by(const DataFrameView& df, int id, int numThreads, const string& groupCol, const string& targetCol, ThreadPool& pool, bool approximate = false);
 DataFrame get_hour_by_time(const DataFrame& df, int id, int numThreads, const string& colName, ThreadPool& pool);
-DataFrame num_transac_by_hour(const DataFrame& df, int id, int numThreads, const string& hourCol, int numDays, ThreadPool& pool);
+DataFrame time_histogram(const DataFrameView& df, int id, int numThreads, const string& colName, TimeUnit unit, int bucketWidth, int numDays, ThreadPool& pool);
+DataFrame num_transac_by_hour(const DataFrameView& df, int id, int numThreads, const string& hourCol, int numDays, ThreadPool& pool);
+DataFrame extract_datetime_part(const DataFrameView& df, int id, int numThreads, const string& colName, TimeUnit part, ThreadPool& pool);
+DataFrame filter_time_range(const DataFrameView& df, int id, int numThreads, const string& colName, const string& from, const string& to, ThreadPool& pool);
 DataFrame classify_accounts_parallel(DataFrame& df, int id, int numThreads, const string& idCol, const string& classFirst, const string& classSec, ThreadPool& tp);
-DataFrame sort_by_column_parallel(const DataFrame& df, int id, int numThreads, const string& keyCol, ThreadPool& pool, bool ascending);
-unordered_map<string, ElementType> getQuantiles(const DataFrame& df, int id, int numThreads, const string& colName, const vector<double>& quantiles, ThreadPool& pool);
-double calculateMeanParallel(const DataFrame& df, int id, int numThreads, const string& targetCol, ThreadPool& pool);
-DataFrame summaryStats(const DataFrame& df, int id, int numThreads, const string& colName, ThreadPool& pool);
-DataFrame top_10_cidades_transacoes(const DataFrame& df, int id, int numThreads, const string& colName, ThreadPool& pool);
+DataFrame gather_rows(const DataFrameView& df, const vector<size_t>& rows, int id, int numThreads, ThreadPool& pool);
+DataFrame materialize(const DataFrameView& view, int id, int numThreads, ThreadPool& pool);
+DataFrame sort_by_columns_parallel(const DataFrameView& df, int id, int numThreads, const vector<string>& keyCols, const vector<bool>& ascending, ThreadPool& pool);
+DataFrame sort_by_column_parallel(const DataFrameView& df, int id, int numThreads, const string& keyCol, ThreadPool& pool, bool ascending);
+vector<double> extract_numeric_column(const DataFrameView& df, const string& colName, int id, int numThreads, ThreadPool& pool);
+vector<double> select_ranks(const vector<double>& values, const vector<size_t>& ranks, int id, int numThreads, ThreadPool& pool);
+unordered_map<string, ElementType> getQuantiles(const DataFrameView& df, int id, int numThreads, const string& colName, const vector<double>& quantiles, ThreadPool& pool);
+KLLSketch build_quantile_sketch(const DataFrameView& df, int id, int numThreads, const string& colName, ThreadPool& pool, int k = KLL_DEFAULT_K);
+unordered_map<string, ElementType> getQuantilesApprox(const DataFrameView& df, int id, int numThreads, const string& colName, const vector<double>& quantiles, ThreadPool& pool, int k = KLL_DEFAULT_K);
+DataFrame groupby_quantiles(const DataFrameView& df, int id, int numThreads, const string& groupCol, const string& targetCol, const vector<double>& quantiles, ThreadPool& pool, int k = KLL_DEFAULT_K);
+double calculateMeanParallel(const DataFrameView& df, int id, int numThreads, const string& targetCol, ThreadPool& pool);
+vector<ColumnSummary> summarize_columns(const DataFrameView& df, int id, int numThreads, const vector<string>& colNames, const vector<double>& quantiles, ThreadPool& pool, bool approximate = false);
+DataFrame describe(const DataFrameView& df, int id, int numThreads, const vector<string>& colNames, ThreadPool& pool, bool approximate = false);
+DataFrame summaryStats(const DataFrameView& df, int id, int numThreads, const string& colName, ThreadPool& pool, bool approximate = false);
+DataFrame top_k(const DataFrameView& df, int id, int numThreads, const string& keyCol, size_t k, bool ascending, ThreadPool& pool);
+DataFrame top_10_cidades_transacoes(const DataFrameView& df, int id, int numThreads, const string& colName, ThreadPool& pool);
 DataFrame abnormal_transactions(const DataFrame& dfTransac, const DataFrame& dfAccount, int id, int numThreads, const string& transactionIDCol, const string& amountCol, const string& locationColTransac, const string& accountColTransac, const string& accountColAccount, const string& locationColAccount, ThreadPool& pool);
 
 #endif
\ No newline at end of file
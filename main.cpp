@@ -1,16 +1,19 @@
 #include <iostream>
 #include <future>
+#include <filesystem>
 #include "include/df.h"
 #include "include/tratadores.h"
 #include "include/csv_extractor.h"
 #include "include/sql_extractor.h"
+#include "include/snapshot.h"
+#include "include/result_sink.h"
 #include "include/threads.h"
 
 using namespace std;
 
 // transactions
-// transation_id,account_id,recipient_id,amount,type,time_start,location,processed_at
-// 0,1,9810,4467.93,retirada,13:10:01.847319,Abbottchester,13:10:49.847319
+// transation_id,account_id,recipient_id,amount,type,location,time_start,time_end,date
+// 0,6565,2555,418.71,retirada,Brasília,00:02:40.113710,00:03:27.113710,2025-01-01
 
 // accounts
 // customer_id,account_id,current_balance,account_type,opening_date,account_status,account_location
@@ -33,50 +36,82 @@ enum PoolID {
     TOP_CITIES = 8,
     STATS = 9, 
     NUM_DAYS = 10,
-    MEAN_NUM_TRANSACTIONS = 11
+    MEAN_NUM_TRANSACTIONS = 11,
+    WRITE_RESULTS = 12
 };
 
+DataFrame* readCSVWithSnapshot(int id, const string& csvFile, int numThreads, const vector<string>& colTypes, ThreadPool& pool) {
+    /*
+    Lê o CSV pelo snapshot binário ao lado dele (csvFile + ".dfsnap") quando o snapshot é mais
+    novo que o CSV e tem os mesmos tipos de coluna; caso contrário lê o CSV e grava o snapshot
+    para as próximas execuções.
+    */
+    string snapshotFile = csvFile + ".dfsnap";
+    error_code ec;
+    if (filesystem::exists(snapshotFile, ec) &&
+        filesystem::last_write_time(snapshotFile, ec) >= filesystem::last_write_time(csvFile, ec)) {
+        DataFrame* df = readSnapshot(snapshotFile);
+        bool sameTypes = df && df->getNumCols() == static_cast<int>(colTypes.size());
+        for (int j = 0; sameTypes && j < df->getNumCols(); ++j) sameTypes = df->getColumnType(j) == colTypes[j];
+        if (sameTypes) return df;
+        delete df;
+    }
+
+    DataFrame* df = readCSV(id, csvFile, numThreads, colTypes, pool);
+    writeSnapshot(*df, snapshotFile);
+    return df;
+}
+
 int main() {
     // Número de threads concorrentes do sistema
     const int NUM_THREADS = thread::hardware_concurrency();
     ThreadPool pool(NUM_THREADS);
+
+    // Os resultados são salvos em output/ como CSV e como arquivo Arrow (output/<nome>.arrow,
+    // que o dashboard abre com memory map) por uma thread de escrita em segundo plano,
+    // enquanto as próximas análises são calculadas
+    ResultSink sink(WRITE_RESULTS, NUM_THREADS, pool);
     cout << "Quantidade de threads concorrentes disponíveis no sistema: " << NUM_THREADS << endl;
     cout << "--------------------------\n\n" << endl;
 
     // Tipagem das colunas
-    vector<string> transactionsColTypes = {"int", "int", "int", "float", "string", "string", "string", "string"};
-    vector<string> accountsColTypes = {"int", "int", "float", "string", "string", "string", "string"};
+    vector<string> transactionsColTypes = {"int", "int", "int", "decimal", "string", "string", "time", "time", "date"};
+    vector<string> accountsColTypes = {"int", "int", "decimal", "string", "date", "string", "string"};
     vector<string> customersColTypes = {"int", "string", "string", "string", "string"};
 
+    // Os DataFrames lidos ficam em handles compartilhados (DataFramePtr), liberados no fim do
+    // programa; os resultados das etapas são movidos dos futures, sem cópia das colunas.
+    // Depois da primeira execução, os CSVs são lidos dos snapshots binários (.dfsnap).
+
     // Leitura do arquivo de transações
     auto transactionsTime = chrono::high_resolution_clock::now();
-    future<DataFrame*> transactionsFuture = pool.enqueue(READ_TRANSACTIONS, [&]() {
-        return readCSV(READ_TRANSACTIONS, "data/transactions/transactions.csv", NUM_THREADS, transactionsColTypes, pool);
+    future<DataFramePtr> transactionsFuture = pool.enqueue(READ_TRANSACTIONS, [&]() {
+        return DataFramePtr(readCSVWithSnapshot(READ_TRANSACTIONS, "data/transactions/transactions.csv", NUM_THREADS, transactionsColTypes, pool));
     });
     pool.isReady(READ_TRANSACTIONS);
-    DataFrame* transactions = transactionsFuture.get();
+    DataFramePtr transactions = transactionsFuture.get();
     auto transactionsEndTime = chrono::high_resolution_clock::now();
     auto transactionsDuration = chrono::duration_cast<chrono::milliseconds>(transactionsEndTime - transactionsTime);
     cout << "Dataframe de transações lido com sucesso." << endl;
 
     // Leitura do arquivo de contas
     auto accountsTime = chrono::high_resolution_clock::now();
-    future<DataFrame*> accountsFuture = pool.enqueue(READ_ACCOUNTS, [&]() {
-        return readCSV(READ_ACCOUNTS, "data/accounts/accounts.csv", NUM_THREADS, accountsColTypes, pool);
+    future<DataFramePtr> accountsFuture = pool.enqueue(READ_ACCOUNTS, [&]() {
+        return DataFramePtr(readCSVWithSnapshot(READ_ACCOUNTS, "data/accounts/accounts.csv", NUM_THREADS, accountsColTypes, pool));
     });
     pool.isReady(READ_ACCOUNTS);
-    DataFrame* accounts = accountsFuture.get();
+    DataFramePtr accounts = accountsFuture.get();
     auto accountsEndTime = chrono::high_resolution_clock::now();
     auto accountsDuration = chrono::duration_cast<chrono::milliseconds>(accountsEndTime - accountsTime);
     cout << "Dataframe de contas lido com sucesso." << endl;
 
     // Leitura do arquivo de clientes
     auto customersTime = chrono::high_resolution_clock::now();
-    future<DataFrame*> customersFuture = pool.enqueue(READ_CUSTOMERS, [&]() {
-        return readCSV(READ_CUSTOMERS, "data/customers/customers.csv", NUM_THREADS, customersColTypes, pool);
+    future<DataFramePtr> customersFuture = pool.enqueue(READ_CUSTOMERS, [&]() {
+        return DataFramePtr(readCSVWithSnapshot(READ_CUSTOMERS, "data/customers/customers.csv", NUM_THREADS, customersColTypes, pool));
     });
     pool.isReady(READ_CUSTOMERS);
-    DataFrame* customers = customersFuture.get();
+    DataFramePtr customers = customersFuture.get();
     auto customersEndTime = chrono::high_resolution_clock::now();
     auto customersDuration = chrono::duration_cast<chrono::milliseconds>(customersEndTime - customersTime);
     cout << "Dataframe de clientes lido com sucesso." << endl;
@@ -98,7 +133,7 @@ int main() {
     cout << "Identificando transações anômalas..." << endl;
     DataFrame abnormal = abnormals.get();
     cout << abnormal.getNumRecords() << " transações anômalas" << endl;
-    abnormal.DFtoCSV("output/abnormal_transactions");
+    sink.submit(abnormal, "output/abnormal_transactions", SINK_CSV | SINK_ARROW);
 
     cout << "\n Você quer ver o dataframe com a classificação das transações anômalas? (y/n)" << endl;
     cout << "(Aviso: esse dataframe pode ser muito grande)" << endl;
@@ -135,7 +170,7 @@ int main() {
     cout << "Classificando clientes..." << endl;
     DataFrame classified = classifications.get();
     cout << classified.getNumRecords() << " clientes classificados com sucesso." << endl; 
-    classified.DFtoCSV("output/classified_accounts");
+    sink.submit(classified, "output/classified_accounts", SINK_CSV | SINK_ARROW);
 
     cout << "\n Você quer ver o dataframe com a classificação dos clientes? (y/n)" << endl;
     cout << "(Aviso: esse dataframe pode ser muito grande)" << endl;
@@ -152,7 +187,7 @@ int main() {
     pool.isReady(TOP_CITIES);
     DataFrame top_cities = top_10_cities.get();
     cout << top_cities.getNumRecords() << " capitais mais ativas classificadas com sucesso." << endl;
-    top_cities.DFtoCSV("output/top_10_cities");
+    sink.submit(top_cities, "output/top_10_cities", SINK_CSV | SINK_ARROW);
 
     cout << "\n Você quer ver o dataframe com as 10 capitais mais ativas? (y/n)" << endl;
     cin >> answer;
@@ -168,7 +203,7 @@ int main() {
     pool.isReady(STATS);
     DataFrame summary = stats.get();
     cout << summary.getNumRecords() << " estatísticas descritivas calculadas com sucesso." << endl;
-    summary.DFtoCSV("output/summary_stats");
+    sink.submit(summary, "output/summary_stats", SINK_CSV | SINK_ARROW);
 
     cout << "\n Você quer ver o dataframe com as estatísticas descritivas dos valores das transações? (y/n)" << endl;
     cin >> answer;
@@ -180,11 +215,10 @@ int main() {
     cout << "[ CALCULANDO A MÉDIA DE TRANSAÇÕES POR HORA ]" << endl;
     
     auto countDays = pool.enqueue(NUM_DAYS, [&](){
-        return count_values(*transactions, 10, NUM_THREADS, "date", 0, pool);
+        return count_distinct(*transactions, 10, NUM_THREADS, "date", pool);
     });
     pool.isReady(NUM_DAYS);
-    DataFrame dfNumDays = countDays.get();
-    int numDays = dfNumDays.getNumRecords();
+    int numDays = countDays.get();
 
     auto numTransac = pool.enqueue(MEAN_NUM_TRANSACTIONS, [&]{
         return num_transac_by_hour(*transactions, 10, NUM_THREADS, "time_start", numDays, pool);
@@ -192,7 +226,7 @@ int main() {
     pool.isReady(MEAN_NUM_TRANSACTIONS);
     DataFrame dfNumTransac = numTransac.get();
     cout << dfNumTransac.getNumRecords() << " transações para cada hora obtidas." << endl;
-    dfNumTransac.DFtoCSV("output/num_transactions");
+    sink.submit(dfNumTransac, "output/num_transactions", SINK_CSV | SINK_ARROW);
 
     cout << "\n Você quer ver o dataframe com a média de transações por hora? (y/n)" << endl;
     cin >> answer;
@@ -200,5 +234,9 @@ int main() {
         dfNumTransac.printDF();
     }
 
+    // Espera a escrita dos resultados terminar
+    sink.flush();
+    if (sink.getFailures() > 0) cerr << sink.getFailures() << " arquivo(s) de resultado não puderam ser escritos" << endl;
+
     return 0;
 }
@@ -0,0 +1,829 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <variant>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include "../include/df.h"
+#include "../include/df_builder.h"
+#include "../include/arrow_ipc.h"
+
+using namespace std;
+using ElementType = variant<int, float, bool, string, long long>; // Tipo possível das variáveis
+
+// Constantes do formato (Schema.fbs, Message.fbs e File.fbs do Arrow)
+static const char ARROW_MAGIC[6] = {'A', 'R', 'R', 'O', 'W', '1'};
+static const int16_t METADATA_V5 = 4;
+static const uint32_t CONTINUATION = 0xFFFFFFFF;
+
+enum ArrowType : uint8_t {
+    ARROW_INT = 2, ARROW_FLOAT = 3, ARROW_UTF8 = 5, ARROW_BOOL = 6, ARROW_DECIMAL = 7,
+    ARROW_DATE = 8, ARROW_TIME = 9, ARROW_TIMESTAMP = 10, ARROW_LARGE_UTF8 = 20
+};
+enum ArrowMessage : uint8_t { MESSAGE_SCHEMA = 1, MESSAGE_RECORD_BATCH = 3 };
+enum ArrowUnit : int16_t { UNIT_SECOND = 0, UNIT_MILLI = 1, UNIT_MICRO = 2, UNIT_NANO = 3 };
+
+// Structs dos flatbuffers, com o layout do formato
+struct FieldNode { int64_t length; int64_t nullCount; };
+struct BufferSpec { int64_t offset; int64_t length; };
+struct Block { int64_t offset; int32_t metaDataLength; int32_t padding; int64_t bodyLength; };
+
+
+/*
+Construção de flatbuffers. Os objetos formam uma árvore que é serializada da frente para
+trás: cada objeto é escrito antes dos seus filhos, então todos os offsets apontam para a
+frente, como o formato exige. As vtables ficam logo antes da sua tabela.
+*/
+struct FbNode;
+using FbRef = shared_ptr<FbNode>;
+
+struct FbNode {
+    enum Kind { TABLE, STRING, STRUCT_VECTOR, TABLE_VECTOR } kind;
+
+    // TABLE: campos escalares (bytes + alinhamento) ou filhos (offset)
+    struct Field { int id; vector<uint8_t> bytes; size_t align; FbRef child; };
+    vector<Field> fields;
+
+    string text;                          // STRING
+    vector<uint8_t> elements;             // STRUCT_VECTOR
+    size_t count = 0, elementAlign = 1;
+    vector<FbRef> items;                  // TABLE_VECTOR
+
+    explicit FbNode(Kind kind) : kind(kind) {}
+
+    template <typename T>
+    FbNode& scalar(int id, T value) {
+        vector<uint8_t> bytes(sizeof(T));
+        memcpy(bytes.data(), &value, sizeof(T));
+        fields.push_back({id, move(bytes), sizeof(T), nullptr});
+        return *this;
+    }
+
+    FbNode& child(int id, FbRef node) {
+        fields.push_back({id, {}, 4, move(node)});
+        return *this;
+    }
+};
+
+static FbRef fbTable() { return make_shared<FbNode>(FbNode::TABLE); }
+
+static FbRef fbString(const string& text) {
+    FbRef node = make_shared<FbNode>(FbNode::STRING);
+    node->text = text;
+    return node;
+}
+
+template <typename T>
+static FbRef fbStructVector(const vector<T>& values) {
+    FbRef node = make_shared<FbNode>(FbNode::STRUCT_VECTOR);
+    node->elements.resize(values.size() * sizeof(T));
+    if (!values.empty()) memcpy(node->elements.data(), values.data(), node->elements.size());
+    node->count = values.size();
+    node->elementAlign = alignof(T);
+    return node;
+}
+
+static FbRef fbTableVector(vector<FbRef> tables) {
+    FbRef node = make_shared<FbNode>(FbNode::TABLE_VECTOR);
+    node->items = move(tables);
+    return node;
+}
+
+class FbWriter {
+    public:
+        vector<uint8_t> finish(const FbRef& root) {
+            out.assign(4, 0);
+            size_t rootPos = write(root);
+            patch(0, static_cast<uint32_t>(rootPos));
+            pad(8);
+            return move(out);
+        }
+
+    private:
+        vector<uint8_t> out;
+
+        void pad(size_t align) {
+            while (out.size() % align) out.push_back(0);
+        }
+
+        template <typename T>
+        void put(T value) {
+            size_t pos = out.size();
+            out.resize(pos + sizeof(T));
+            memcpy(out.data() + pos, &value, sizeof(T));
+        }
+
+        void patch(size_t at, uint32_t value) {
+            memcpy(out.data() + at, &value, sizeof(value));
+        }
+
+        size_t write(const FbRef& node) {
+            switch (node->kind) {
+                case FbNode::STRING: {
+                    pad(4);
+                    size_t pos = out.size();
+                    put<uint32_t>(node->text.size());
+                    out.insert(out.end(), node->text.begin(), node->text.end());
+                    out.push_back(0);
+                    return pos;
+                }
+                case FbNode::STRUCT_VECTOR: {
+                    // Os elementos (logo após o tamanho) precisam do alinhamento da struct
+                    size_t align = max<size_t>(4, node->elementAlign);
+                    while ((out.size() + 4) % align) out.push_back(0);
+                    size_t pos = out.size();
+                    put<uint32_t>(node->count);
+                    out.insert(out.end(), node->elements.begin(), node->elements.end());
+                    return pos;
+                }
+                case FbNode::TABLE_VECTOR: {
+                    pad(4);
+                    size_t pos = out.size();
+                    put<uint32_t>(node->items.size());
+                    size_t slots = out.size();
+                    out.resize(slots + 4 * node->items.size(), 0);
+                    for (size_t i = 0; i < node->items.size(); ++i) {
+                        size_t slot = slots + 4 * i;
+                        size_t target = write(node->items[i]);
+                        patch(slot, static_cast<uint32_t>(target - slot));
+                    }
+                    return pos;
+                }
+                case FbNode::TABLE:
+                    break;
+            }
+
+            // Layout da tabela: soffset para a vtable e os campos, maiores alinhamentos primeiro
+            vector<const FbNode::Field*> ordered;
+            int maxId = -1;
+            for (const auto& field : node->fields) {
+                ordered.push_back(&field);
+                maxId = max(maxId, field.id);
+            }
+            stable_sort(ordered.begin(), ordered.end(), [](const FbNode::Field* a, const FbNode::Field* b) {
+                return a->align > b->align;
+            });
+            vector<uint16_t> slotOffsets(maxId + 1, 0);
+            vector<size_t> fieldOffsets(ordered.size());
+            size_t tableSize = 4;
+            for (size_t f = 0; f < ordered.size(); ++f) {
+                size_t align = ordered[f]->align;
+                tableSize = (tableSize + align - 1) / align * align;
+                fieldOffsets[f] = tableSize;
+                slotOffsets[ordered[f]->id] = static_cast<uint16_t>(tableSize);
+                tableSize += ordered[f]->child ? 4 : ordered[f]->bytes.size();
+            }
+
+            // vtable imediatamente antes da tabela, que começa alinhada em 8
+            size_t vtableSize = 4 + 2 * slotOffsets.size();
+            while ((out.size() + vtableSize) % 8) out.push_back(0);
+            size_t vtablePos = out.size();
+            put<uint16_t>(vtableSize);
+            put<uint16_t>(tableSize);
+            for (uint16_t offset : slotOffsets) put<uint16_t>(offset);
+
+            size_t tablePos = out.size();
+            out.resize(tablePos + tableSize, 0);
+            int32_t soffset = static_cast<int32_t>(tablePos - vtablePos);
+            memcpy(out.data() + tablePos, &soffset, sizeof(soffset));
+            for (size_t f = 0; f < ordered.size(); ++f) {
+                if (!ordered[f]->child) {
+                    memcpy(out.data() + tablePos + fieldOffsets[f], ordered[f]->bytes.data(), ordered[f]->bytes.size());
+                }
+            }
+
+            // Filhos depois da tabela
+            for (size_t f = 0; f < ordered.size(); ++f) {
+                if (!ordered[f]->child) continue;
+                size_t slot = tablePos + fieldOffsets[f];
+                size_t target = write(ordered[f]->child);
+                patch(slot, static_cast<uint32_t>(target - slot));
+            }
+            return tablePos;
+        }
+};
+
+
+// Tipo Arrow de uma coluna e o índice do variant esperado nos seus valores
+struct ArrowColumn {
+    ArrowType type;
+    size_t valueIndex;
+    string dfType;
+};
+
+static ArrowColumn arrowColumnFor(const string& type) {
+    if (type == "int") return {ARROW_INT, 0, type};
+    if (type == "float") return {ARROW_FLOAT, 1, type};
+    if (type == "bool") return {ARROW_BOOL, 2, type};
+    if (type == "date") return {ARROW_DATE, 0, type};
+    if (type == "time") return {ARROW_TIME, 4, type};
+    if (type == "timestamp") return {ARROW_TIMESTAMP, 4, type};
+    if (type == "decimal") return {ARROW_DECIMAL, 4, type};
+    return {ARROW_UTF8, 3, type};
+}
+
+static FbRef arrowTypeTable(ArrowType type) {
+    FbRef table = fbTable();
+    switch (type) {
+        case ARROW_INT: table->scalar<int32_t>(0, 32).scalar<uint8_t>(1, 1); break;
+        case ARROW_FLOAT: table->scalar<int16_t>(0, 1); break;                       // SINGLE
+        case ARROW_DECIMAL: table->scalar<int32_t>(0, 19).scalar<int32_t>(1, 2).scalar<int32_t>(2, 128); break;
+        case ARROW_DATE: table->scalar<int16_t>(0, 0); break;                        // DAY
+        case ARROW_TIME: table->scalar<int16_t>(0, UNIT_MICRO).scalar<int32_t>(1, 64); break;
+        case ARROW_TIMESTAMP: table->scalar<int16_t>(0, UNIT_MICRO); break;
+        default: break;                                                              // Utf8 e Bool não têm campos
+    }
+    return table;
+}
+
+static FbRef schemaTable(const DataFrame& df, const vector<ArrowColumn>& columns) {
+    vector<FbRef> fields;
+    for (size_t j = 0; j < columns.size(); ++j) {
+        FbRef field = fbTable();
+        field->child(0, fbString(df.getColumnName(j)))
+              .scalar<uint8_t>(1, 1)                                   // nullable
+              .scalar<uint8_t>(2, columns[j].type)
+              .child(3, arrowTypeTable(columns[j].type))
+              .child(5, fbTableVector({}));                            // children
+        fields.push_back(field);
+    }
+    FbRef schema = fbTable();
+    schema->scalar<int16_t>(0, 0).child(1, fbTableVector(move(fields)));   // Little endian
+    return schema;
+}
+
+static vector<uint8_t> messageBytes(uint8_t headerType, FbRef header, int64_t bodyLength) {
+    FbRef message = fbTable();
+    message->scalar<int16_t>(0, METADATA_V5)
+            .scalar<uint8_t>(1, headerType)
+            .child(2, move(header))
+            .scalar<int64_t>(3, bodyLength);
+    return FbWriter().finish(message);
+}
+
+static void appendBuffer(vector<char>& body, vector<BufferSpec>& buffers, const void* data, size_t size) {
+    // Buffers do corpo alinhados em 8 bytes
+    buffers.push_back({static_cast<int64_t>(body.size()), static_cast<int64_t>(size)});
+    const char* bytes = static_cast<const char*>(data);
+    body.insert(body.end(), bytes, bytes + size);
+    body.resize((body.size() + 7) & ~static_cast<size_t>(7), 0);
+}
+
+template <typename T, typename Read>
+static void appendFixedWidth(vector<char>& body, vector<BufferSpec>& buffers, const Column& column, size_t start, size_t end, Read read) {
+    vector<T> values(end - start);
+    for (size_t i = start; i < end; ++i) values[i - start] = read(column[i]);
+    appendBuffer(body, buffers, values.data(), values.size() * sizeof(T));
+}
+
+static void appendColumnBuffers(vector<char>& body, vector<BufferSpec>& buffers, const Column& column, const ArrowColumn& arrow, size_t start, size_t end) {
+    /*Escreve os buffers de uma coluna no trecho [start, end): validade (vazia, sem nulos) e dados.*/
+    appendBuffer(body, buffers, nullptr, 0);
+    switch (arrow.type) {
+        case ARROW_INT:
+        case ARROW_DATE:
+            appendFixedWidth<int32_t>(body, buffers, column, start, end, [](const ElementType& v) { return get<int>(v); });
+            break;
+        case ARROW_FLOAT:
+            appendFixedWidth<float>(body, buffers, column, start, end, [](const ElementType& v) { return get<float>(v); });
+            break;
+        case ARROW_TIME:
+        case ARROW_TIMESTAMP:
+            appendFixedWidth<int64_t>(body, buffers, column, start, end, [](const ElementType& v) { return get<long long>(v); });
+            break;
+        case ARROW_DECIMAL: {
+            // decimal128: inteiro de 128 bits em complemento de dois (parte baixa primeiro)
+            vector<int64_t> words(2 * (end - start));
+            for (size_t i = start; i < end; ++i) {
+                long long cents = get<long long>(column[i]);
+                words[2 * (i - start)] = cents;
+                words[2 * (i - start) + 1] = cents < 0 ? -1 : 0;
+            }
+            appendBuffer(body, buffers, words.data(), words.size() * sizeof(int64_t));
+            break;
+        }
+        case ARROW_BOOL: {
+            vector<uint8_t> bits((end - start + 7) / 8, 0);
+            for (size_t i = start; i < end; ++i) {
+                if (get<bool>(column[i])) bits[(i - start) / 8] |= static_cast<uint8_t>(1u << ((i - start) % 8));
+            }
+            appendBuffer(body, buffers, bits.data(), bits.size());
+            break;
+        }
+        default: {
+            // utf8: deslocamentos int32 e os bytes das strings (valores fora do tipo são formatados)
+            vector<int32_t> offsets(1, 0);
+            string data;
+            for (size_t i = start; i < end; ++i) {
+                if (const string* text = get_if<string>(&column[i])) data += *text;
+                else data += formatValue(column[i], arrow.dfType);
+                offsets.push_back(static_cast<int32_t>(data.size()));
+            }
+            appendBuffer(body, buffers, offsets.data(), offsets.size() * sizeof(int32_t));
+            appendBuffer(body, buffers, data.data(), data.size());
+            break;
+        }
+    }
+}
+
+static void writeMessage(ofstream& outFile, size_t& position, const vector<uint8_t>& metadata, const vector<char>& body, Block* block) {
+    // Mensagem encapsulada: marca de continuação, tamanho dos metadados, metadados e corpo
+    if (block) block->offset = position;
+    uint32_t continuation = CONTINUATION;
+    int32_t metadataSize = static_cast<int32_t>(metadata.size());
+    outFile.write(reinterpret_cast<const char*>(&continuation), 4);
+    outFile.write(reinterpret_cast<const char*>(&metadataSize), 4);
+    outFile.write(reinterpret_cast<const char*>(metadata.data()), metadata.size());
+    outFile.write(body.data(), body.size());
+    position += 8 + metadata.size() + body.size();
+    if (block) {
+        block->metaDataLength = 8 + metadataSize;
+        block->padding = 0;
+        block->bodyLength = body.size();
+    }
+}
+
+bool writeArrow(const DataFrame& df, const string& filename) {
+    /*
+    Escreve o DataFrame como arquivo Arrow IPC: magic, mensagem de schema, um record batch
+    a cada ARROW_BATCH_ROWS linhas, marca de fim de stream, footer e magic final. O arquivo
+    é escrito em filename.tmp e renomeado no fim.
+    */
+    size_t numCols = df.getNumCols();
+    size_t numRecords = df.getNumRecords();
+
+    // Colunas com valores fora do tipo declarado são escritas como utf8
+    vector<ArrowColumn> columns;
+    for (size_t j = 0; j < numCols; ++j) {
+        ArrowColumn arrow = arrowColumnFor(df.getColumnType(j));
+        for (const auto& value : df.columns[j]) {
+            if (value.index() != arrow.valueIndex) {
+                arrow = {ARROW_UTF8, 3, arrow.dfType};
+                break;
+            }
+        }
+        columns.push_back(arrow);
+    }
+
+    string tmpName = filename + ".tmp";
+    ofstream outFile(tmpName, ios::binary | ios::trunc);
+    if (!outFile.is_open()) {
+        cerr << "Erro ao abrir o arquivo para escrita: " << tmpName << endl;
+        return false;
+    }
+
+    const char padding[2] = {0, 0};
+    outFile.write(ARROW_MAGIC, sizeof(ARROW_MAGIC));
+    outFile.write(padding, sizeof(padding));
+    size_t position = 8;
+
+    writeMessage(outFile, position, messageBytes(MESSAGE_SCHEMA, schemaTable(df, columns), 0), {}, nullptr);
+
+    vector<Block> blocks;
+    for (size_t start = 0; start < numRecords || (start == 0 && blocks.empty()); start += ARROW_BATCH_ROWS) {
+        size_t end = min(start + ARROW_BATCH_ROWS, numRecords);
+        vector<char> body;
+        vector<FieldNode> nodes;
+        vector<BufferSpec> buffers;
+        for (size_t j = 0; j < numCols; ++j) {
+            nodes.push_back({static_cast<int64_t>(end - start), 0});
+            appendColumnBuffers(body, buffers, df.columns[j], columns[j], start, end);
+        }
+
+        FbRef batch = fbTable();
+        batch->scalar<int64_t>(0, end - start)
+              .child(1, fbStructVector(nodes))
+              .child(2, fbStructVector(buffers));
+
+        Block block;
+        writeMessage(outFile, position, messageBytes(MESSAGE_RECORD_BATCH, batch, body.size()), body, &block);
+        blocks.push_back(block);
+        if (numRecords == 0) break;
+    }
+
+    // Fim do stream e footer
+    uint32_t endOfStream[2] = {CONTINUATION, 0};
+    outFile.write(reinterpret_cast<const char*>(endOfStream), sizeof(endOfStream));
+
+    FbRef footer = fbTable();
+    footer->scalar<int16_t>(0, METADATA_V5)
+           .child(1, schemaTable(df, columns))
+           .child(2, fbStructVector(vector<Block>()))
+           .child(3, fbStructVector(blocks));
+    vector<uint8_t> footerBytes = FbWriter().finish(footer);
+    int32_t footerSize = static_cast<int32_t>(footerBytes.size());
+    outFile.write(reinterpret_cast<const char*>(footerBytes.data()), footerBytes.size());
+    outFile.write(reinterpret_cast<const char*>(&footerSize), sizeof(footerSize));
+    outFile.write(ARROW_MAGIC, sizeof(ARROW_MAGIC));
+    outFile.close();
+
+    if (!outFile) {
+        cerr << "Erro ao escrever o arquivo Arrow: " << tmpName << endl;
+        remove(tmpName.c_str());
+        return false;
+    }
+    if (rename(tmpName.c_str(), filename.c_str()) != 0) {
+        cerr << "Erro ao renomear o arquivo Arrow para " << filename << endl;
+        remove(tmpName.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+// Leitura de flatbuffers com verificação de limites; erros lançam runtime_error, tratado em readArrow
+struct FbTableReader {
+    const uint8_t* buf;
+    size_t size;
+    size_t pos;
+
+    template <typename T>
+    static T load(const uint8_t* buf, size_t size, size_t at) {
+        if (at > size || sizeof(T) > size - at) throw runtime_error("flatbuffer truncado");
+        T value;
+        memcpy(&value, buf + at, sizeof(T));
+        return value;
+    }
+
+    static FbTableReader root(const uint8_t* buf, size_t size) {
+        return FbTableReader{buf, size, load<uint32_t>(buf, size, 0)};
+    }
+
+    size_t fieldPos(int id) const {
+        size_t vtable = pos - load<int32_t>(buf, size, pos);
+        uint16_t vtableSize = load<uint16_t>(buf, size, vtable);
+        size_t entry = 4 + 2 * static_cast<size_t>(id);
+        if (entry + 2 > vtableSize) return 0;
+        uint16_t offset = load<uint16_t>(buf, size, vtable + entry);
+        return offset ? pos + offset : 0;
+    }
+
+    bool has(int id) const { return fieldPos(id) != 0; }
+
+    template <typename T>
+    T scalar(int id, T defaultValue) const {
+        size_t at = fieldPos(id);
+        return at ? load<T>(buf, size, at) : defaultValue;
+    }
+
+    size_t target(int id) const {
+        size_t at = fieldPos(id);
+        if (!at) throw runtime_error("campo obrigatório ausente");
+        return at + load<uint32_t>(buf, size, at);
+    }
+
+    FbTableReader table(int id) const { return FbTableReader{buf, size, target(id)}; }
+
+    string text(int id) const {
+        size_t at = target(id);
+        uint32_t length = load<uint32_t>(buf, size, at);
+        if (length > size - at - 4) throw runtime_error("string truncada");
+        return string(reinterpret_cast<const char*>(buf + at + 4), length);
+    }
+
+    // Vetor: retorna a posição do primeiro elemento e o número de elementos (0 se ausente)
+    size_t vector(int id, uint32_t& length) const {
+        length = 0;
+        if (!has(id)) return 0;
+        size_t at = target(id);
+        length = load<uint32_t>(buf, size, at);
+        return at + 4;
+    }
+
+    FbTableReader tableAt(size_t elementPos) const {
+        return FbTableReader{buf, size, elementPos + load<uint32_t>(buf, size, elementPos)};
+    }
+};
+
+// Descrição de uma coluna lida: tipo do DataFrame e como converter os valores
+struct ArrowField {
+    string name;
+    string dfType;
+    uint8_t type;
+    int bitWidth = 0;
+    bool isSigned = true;
+    int16_t unit = UNIT_MICRO;
+    int scale = 0;
+};
+
+static ArrowField readField(const FbTableReader& field) {
+    ArrowField result;
+    result.name = field.has(0) ? field.text(0) : "";
+    result.type = field.scalar<uint8_t>(2, 0);
+    if (field.has(4)) throw runtime_error("colunas com dicionário não são suportadas");
+    uint32_t children;
+    field.vector(5, children);
+    if (children > 0) throw runtime_error("tipos aninhados não são suportados");
+
+    FbTableReader type = field.table(3);
+    switch (result.type) {
+        case ARROW_INT:
+            // int8 a int64 (e uint8 a uint64), lidos em int enquanto os valores couberem
+            result.bitWidth = type.scalar<int32_t>(0, 0);
+            result.isSigned = type.scalar<uint8_t>(1, 0);
+            if (result.bitWidth != 8 && result.bitWidth != 16 && result.bitWidth != 32 && result.bitWidth != 64) {
+                throw runtime_error("inteiro com largura inválida na coluna " + result.name);
+            }
+            result.dfType = "int";
+            break;
+        case ARROW_FLOAT: {
+            int16_t precision = type.scalar<int16_t>(0, 0);
+            if (precision != 1 && precision != 2) throw runtime_error("float16 não é suportado");
+            result.bitWidth = precision == 1 ? 32 : 64;
+            result.dfType = "float";
+            break;
+        }
+        case ARROW_BOOL: result.dfType = "bool"; break;
+        case ARROW_UTF8: case ARROW_LARGE_UTF8: result.dfType = "string"; break;
+        case ARROW_DATE:
+            result.unit = type.scalar<int16_t>(0, 1);    // 0 = dias (date32), 1 = ms (date64)
+            result.dfType = "date";
+            break;
+        case ARROW_TIME:
+            result.unit = type.scalar<int16_t>(0, UNIT_MILLI);
+            result.bitWidth = type.scalar<int32_t>(1, 32);
+            result.dfType = "time";
+            break;
+        case ARROW_TIMESTAMP:
+            result.unit = type.scalar<int16_t>(0, UNIT_SECOND);
+            result.dfType = "timestamp";
+            break;
+        case ARROW_DECIMAL:
+            if (type.scalar<int32_t>(2, 128) != 128) throw runtime_error("só decimal128 é suportado");
+            result.scale = type.scalar<int32_t>(1, 0);
+            result.dfType = "decimal";
+            break;
+        default:
+            throw runtime_error("tipo Arrow não suportado na coluna " + result.name);
+    }
+    return result;
+}
+
+static long long scaleUp(long long value, long long factor) {
+    long long result;
+    if (__builtin_mul_overflow(value, factor, &result)) throw runtime_error("valor fora do intervalo de 64 bits");
+    return result;
+}
+
+static long long toMicros(long long value, int16_t unit) {
+    switch (unit) {
+        case UNIT_SECOND: return scaleUp(value, 1000000LL);
+        case UNIT_MILLI: return scaleUp(value, 1000LL);
+        case UNIT_NANO: return value / 1000LL;
+        default: return value;
+    }
+}
+
+static long long toCents(int64_t low, int scale) {
+    // Reescala para 2 casas decimais (casas extras são truncadas)
+    long long value = low;
+    for (int s = scale; s < 2; ++s) value = scaleUp(value, 10);
+    for (int s = scale; s > 2; --s) value /= 10;
+    return value;
+}
+
+// Bits por linha que uma coluna ocupa no corpo do record batch (sem o bitmap de validade)
+static size_t bitsPerRow(const ArrowField& field) {
+    switch (field.type) {
+        case ARROW_INT: case ARROW_FLOAT: return field.bitWidth;
+        case ARROW_BOOL: return 1;
+        case ARROW_DATE: return field.unit == 0 ? 32 : 64;
+        case ARROW_TIME: return field.bitWidth == 64 ? 64 : 32;
+        case ARROW_TIMESTAMP: return 64;
+        case ARROW_DECIMAL: return 128;
+        case ARROW_LARGE_UTF8: return 64;
+        default: return 32;
+    }
+}
+
+static void readColumn(const char* body, size_t bodySize, const vector<BufferSpec>& buffers, size_t& nextBuffer,
+                       const ArrowField& field, size_t length, size_t row, ColumnBuilder& column) {
+    /*Decodifica os buffers de uma coluna de um record batch a partir da linha row do resultado.*/
+    auto buffer = [&](size_t minSize) -> const char* {
+        if (nextBuffer >= buffers.size()) throw runtime_error("buffers insuficientes no record batch");
+        const BufferSpec& spec = buffers[nextBuffer++];
+        if (spec.offset < 0 || spec.length < 0 || static_cast<size_t>(spec.offset) > bodySize ||
+            static_cast<size_t>(spec.length) > bodySize - spec.offset || static_cast<size_t>(spec.length) < minSize) {
+            throw runtime_error("buffer fora do corpo do record batch");
+        }
+        return body + spec.offset;
+    };
+
+    const BufferSpec* validitySpec = nextBuffer < buffers.size() ? &buffers[nextBuffer] : nullptr;
+    const char* validity = buffer(0);
+    bool hasValidity = validitySpec && validitySpec->length > 0;
+    if (hasValidity && static_cast<size_t>(validitySpec->length) < (length + 7) / 8) throw runtime_error("bitmap de validade truncado");
+    auto valid = [&](size_t i) {
+        return !hasValidity || (static_cast<uint8_t>(validity[i / 8]) >> (i % 8)) & 1;
+    };
+    auto load = [](const char* data, size_t i, auto zero) {
+        decltype(zero) value;
+        memcpy(&value, data + i * sizeof(value), sizeof(value));
+        return value;
+    };
+
+    switch (field.type) {
+        case ARROW_INT: {
+            const char* data = buffer(length * field.bitWidth / 8);
+            for (size_t i = 0; i < length; ++i) {
+                if (!valid(i)) {
+                    column.set(row + i, 0);
+                    continue;
+                }
+                long long value;
+                switch (field.bitWidth) {
+                    // Cada ramo convertido à parte (no ?: int32 e uint32 virariam uint32)
+                    case 8: value = field.isSigned ? static_cast<long long>(load(data, i, int8_t())) : load(data, i, uint8_t()); break;
+                    case 16: value = field.isSigned ? static_cast<long long>(load(data, i, int16_t())) : load(data, i, uint16_t()); break;
+                    case 32: value = field.isSigned ? static_cast<long long>(load(data, i, int32_t())) : load(data, i, uint32_t()); break;
+                    default:
+                        if (field.isSigned) {
+                            value = load(data, i, int64_t());
+                        } else {
+                            uint64_t raw = load(data, i, uint64_t());
+                            if (raw > static_cast<uint64_t>(INT32_MAX)) {
+                                throw runtime_error("valor inteiro fora do intervalo de int: " + to_string(raw));
+                            }
+                            value = static_cast<long long>(raw);
+                        }
+                }
+                if (value < INT32_MIN || value > INT32_MAX) {
+                    throw runtime_error("valor inteiro fora do intervalo de int: " + to_string(value));
+                }
+                column.set(row + i, static_cast<int>(value));
+            }
+            break;
+        }
+        case ARROW_FLOAT: {
+            const char* data = buffer(length * field.bitWidth / 8);
+            for (size_t i = 0; i < length; ++i) {
+                float value = field.bitWidth == 32 ? load(data, i, float()) : static_cast<float>(load(data, i, double()));
+                column.set(row + i, valid(i) ? value : 0.0f);
+            }
+            break;
+        }
+        case ARROW_BOOL: {
+            const char* data = buffer((length + 7) / 8);
+            for (size_t i = 0; i < length; ++i) {
+                column.set(row + i, valid(i) && ((static_cast<uint8_t>(data[i / 8]) >> (i % 8)) & 1));
+            }
+            break;
+        }
+        case ARROW_DATE: {
+            const char* data = buffer(length * (field.unit == 0 ? 4 : 8));
+            for (size_t i = 0; i < length; ++i) {
+                int days = field.unit == 0 ? load(data, i, int32_t()) : static_cast<int>(load(data, i, int64_t()) / 86400000LL);
+                column.set(row + i, valid(i) ? days : 0);
+            }
+            break;
+        }
+        case ARROW_TIME:
+        case ARROW_TIMESTAMP: {
+            bool wide = field.type == ARROW_TIMESTAMP || field.bitWidth == 64;
+            const char* data = buffer(length * (wide ? 8 : 4));
+            for (size_t i = 0; i < length; ++i) {
+                long long value = wide ? load(data, i, int64_t()) : load(data, i, int32_t());
+                column.set(row + i, valid(i) ? toMicros(value, field.unit) : 0LL);
+            }
+            break;
+        }
+        case ARROW_DECIMAL: {
+            const char* data = buffer(length * 16);
+            for (size_t i = 0; i < length; ++i) {
+                column.set(row + i, valid(i) ? toCents(load(data, 2 * i, int64_t()), field.scale) : 0LL);
+            }
+            break;
+        }
+        default: {
+            bool large = field.type == ARROW_LARGE_UTF8;
+            const char* offsets = buffer((length + 1) * (large ? 8 : 4));
+            const BufferSpec& dataSpec = nextBuffer < buffers.size() ? buffers[nextBuffer] : BufferSpec{0, 0};
+            const char* data = buffer(0);
+            auto offsetAt = [&](size_t i) -> int64_t { return large ? load(offsets, i, int64_t()) : load(offsets, i, int32_t()); };
+            for (size_t i = 0; i < length; ++i) {
+                int64_t begin = offsetAt(i), end = offsetAt(i + 1);
+                if (begin < 0 || begin > end || end > dataSpec.length) throw runtime_error("deslocamento de string inválido");
+                column.set(row + i, valid(i) ? string(data + begin, end - begin) : string());
+            }
+            break;
+        }
+    }
+}
+
+DataFrame* readArrow(const string& filename) {
+    /*
+    Lê um arquivo Arrow IPC: confere os magics, lê o schema do footer e decodifica cada
+    record batch listado nele direto nas colunas do resultado.
+    */
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Erro ao abrir o arquivo Arrow: " << filename << endl;
+        return nullptr;
+    }
+    vector<char> contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    const char* data = contents.data();
+    size_t size = contents.size();
+
+    try {
+        if (size < 8 + 10 || memcmp(data, ARROW_MAGIC, 6) != 0 || memcmp(data + size - 6, ARROW_MAGIC, 6) != 0) {
+            throw runtime_error("arquivo não está no formato Arrow IPC");
+        }
+        int32_t footerSize;
+        memcpy(&footerSize, data + size - 10, sizeof(footerSize));
+        if (footerSize <= 0 || static_cast<size_t>(footerSize) > size - 18) throw runtime_error("footer inválido");
+        const uint8_t* footerBuf = reinterpret_cast<const uint8_t*>(data + size - 10 - footerSize);
+        FbTableReader footer = FbTableReader::root(footerBuf, footerSize);
+
+        // Schema
+        FbTableReader schema = footer.table(1);
+        uint32_t numFields;
+        size_t fieldsPos = schema.vector(1, numFields);
+        vector<ArrowField> fields;
+        vector<string> colNames, colTypes;
+        for (uint32_t j = 0; j < numFields; ++j) {
+            fields.push_back(readField(schema.tableAt(fieldsPos + 4 * j)));
+            colNames.push_back(fields.back().name);
+            colTypes.push_back(fields.back().dfType);
+        }
+
+        uint32_t numDictionaries;
+        footer.vector(2, numDictionaries);
+        if (numDictionaries > 0) throw runtime_error("dicionários não são suportados");
+
+        // Blocos dos record batches
+        uint32_t numBlocks;
+        size_t blocksPos = footer.vector(3, numBlocks);
+        vector<Block> blocks(numBlocks);
+        for (uint32_t b = 0; b < numBlocks; ++b) {
+            size_t at = blocksPos + b * sizeof(Block);
+            blocks[b].offset = FbTableReader::load<int64_t>(footerBuf, footerSize, at);
+            blocks[b].metaDataLength = FbTableReader::load<int32_t>(footerBuf, footerSize, at + 8);
+            blocks[b].bodyLength = FbTableReader::load<int64_t>(footerBuf, footerSize, at + 16);
+        }
+
+        // Primeiro os metadados (tamanho total), depois os valores
+        vector<FbTableReader> batches;
+        size_t numRecords = 0;
+        size_t rowBits = 0;
+        for (const ArrowField& field : fields) rowBits += bitsPerRow(field);
+        for (const Block& block : blocks) {
+            if (block.offset < 0 || block.metaDataLength < 8 || static_cast<size_t>(block.offset) > size ||
+                static_cast<size_t>(block.metaDataLength) > size - block.offset || block.bodyLength < 0 ||
+                static_cast<size_t>(block.bodyLength) > size - block.offset - block.metaDataLength) {
+                throw runtime_error("bloco fora do arquivo");
+            }
+            // Mensagem com a marca de continuação (formato atual) ou só com o tamanho (formato antigo)
+            size_t prefix = 4;
+            uint32_t first;
+            memcpy(&first, data + block.offset, 4);
+            if (first == CONTINUATION) prefix = 8;
+            const uint8_t* messageBuf = reinterpret_cast<const uint8_t*>(data + block.offset + prefix);
+            FbTableReader message = FbTableReader::root(messageBuf, block.metaDataLength - prefix);
+            if (message.scalar<uint8_t>(1, 0) != MESSAGE_RECORD_BATCH) throw runtime_error("bloco não é um record batch");
+            FbTableReader batch = message.table(2);
+            if (batch.has(3)) throw runtime_error("record batches comprimidos não são suportados");
+            // O número de linhas tem que caber no corpo antes de dimensionar as colunas
+            int64_t length = batch.scalar<int64_t>(0, 0);
+            if (length < 0 || (rowBits > 0 && static_cast<uint64_t>(length) > static_cast<uint64_t>(block.bodyLength) * 8 / rowBits) ||
+                (rowBits == 0 && length > 0)) {
+                throw runtime_error("record batch com tamanho inválido");
+            }
+            numRecords += length;
+            batches.push_back(batch);
+        }
+
+        DataFrameBuilder builder(colNames, colTypes, numRecords);
+        size_t row = 0;
+        for (size_t b = 0; b < batches.size(); ++b) {
+            const FbTableReader& batch = batches[b];
+            size_t length = batch.scalar<int64_t>(0, 0);
+            const char* body = data + blocks[b].offset + blocks[b].metaDataLength;
+
+            uint32_t numNodes, numBuffers;
+            batch.vector(1, numNodes);
+            size_t buffersPos = batch.vector(2, numBuffers);
+            if (numNodes != fields.size()) throw runtime_error("número de colunas do record batch incompatível");
+            vector<BufferSpec> buffers(numBuffers);
+            for (uint32_t k = 0; k < numBuffers; ++k) {
+                buffers[k].offset = FbTableReader::load<int64_t>(batch.buf, batch.size, buffersPos + 16 * k);
+                buffers[k].length = FbTableReader::load<int64_t>(batch.buf, batch.size, buffersPos + 16 * k + 8);
+            }
+
+            size_t nextBuffer = 0;
+            for (size_t j = 0; j < fields.size(); ++j) {
+                readColumn(body, blocks[b].bodyLength, buffers, nextBuffer, fields[j], length, row, builder.column(j));
+            }
+            row += length;
+        }
+
+        return new DataFrame(builder.finish());
+    } catch (const exception& e) {
+        cerr << "Erro ao ler o arquivo Arrow " << filename << ": " << e.what() << endl;
+        return nullptr;
+    }
+}
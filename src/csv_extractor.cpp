@@ -94,6 +94,7 @@ void processCSVLines(const vector<string>& linesRead, DataFrame* df, int& record
 void processCSVBlocks(const vector<string>& linesRead, DataFrame* df, int& recordsCount, bool& fileAlreadyRead, mutex& mtxFile, mutex& mtxCounter, int& needLines, int blocksize) {
     /*
     Esse método processa as linhas lidas do CSV e preenche o DataFrame.
+    Cada bloco é publicado com a sua linha inicial, então o DataFrame mantém a ordem do arquivo.
     */
    
     while(!fileAlreadyRead || recordsCount < linesRead.size()){
@@ -136,7 +137,8 @@ void processCSVBlocks(const vector<string>& linesRead, DataFrame* df, int& recor
             }
             filteredBlockRead[i] = record;
         }
-        df->addMultipleRecords(filteredBlockRead);
+        // A linha inicial do bloco no arquivo define a sua posição no DataFrame
+        df->addMultipleRecords(filteredBlockRead, beginning);
     }
 }
 
@@ -201,6 +203,8 @@ DataFrame* readCSV(const string& filename, int numThreads, vector<string> colTyp
     //cout << "Tempo de leitura: " << durationRead.count() << " ms" << endl;
     //cout << "Tempo de processamento: " << durationProcess.count() << " ms" << endl;
     
+    // Junta os blocos publicados pelas threads de processamento
+    df->consolidate();
     return df;
 }
 
@@ -272,5 +276,7 @@ DataFrame* readCSV(int id, const string& filename, int numThreads, vector<string
     auto durationRead = chrono::duration_cast<chrono::milliseconds>(endRead - startRead);
     auto durationProcess = chrono::duration_cast<chrono::milliseconds>(endProcess - startProcess);
     
+    // Junta os blocos publicados pelas threads de processamento
+    df->consolidate();
     return df;
 }
\ No newline at end of file
@@ -6,19 +6,87 @@
 #include <unordered_map>
 #include <mutex>
 #include <thread>
-#include <deque>
 #include <iomanip>
 #include <iostream>
 #include <memory>
 #include <fstream>
 #include <sstream>
 #include "../include/df.h"
+#include "../include/threads.h"
 #include <algorithm>
 #include <functional>
+#include <deque>
+#include <future>
 
 using namespace std;
-using ElementType = variant<int, float, bool, string>; // Tipo possível das variáveis
+using ElementType = variant<int, float, bool, string, long long>; // Tipo possível das variáveis
+
+
+bool parseDecimal(const string& text, long long& cents) {
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) negative = text[pos++] == '-';
+
+    // Até 16 dígitos significativos na parte inteira: integerPart * DECIMAL_SCALE + centavos
+    // cabe em long long (zeros à esquerda não contam)
+    const size_t MAX_INTEGER_DIGITS = 16;
+    long long integerPart = 0;
+    size_t digits = 0, significantDigits = 0;
+    for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++digits) {
+        if (integerPart == 0 && text[pos] == '0') continue;
+        if (++significantDigits > MAX_INTEGER_DIGITS) return false;
+        integerPart = integerPart * 10 + (text[pos] - '0');
+    }
 
+    // Duas casas decimais; a terceira decide o arredondamento (metade para longe do zero)
+    long long fraction = 0;
+    int fractionDigits = 0;
+    bool roundUp = false;
+    if (pos < text.size() && text[pos] == '.') {
+        for (++pos; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++digits) {
+            if (fractionDigits < 2) fraction = fraction * 10 + (text[pos] - '0');
+            else if (fractionDigits == 2) roundUp = text[pos] >= '5';
+            fractionDigits++;
+        }
+    }
+    if (digits == 0 || pos != text.size()) return false;
+    for (; fractionDigits < 2; ++fractionDigits) fraction *= 10;
+
+    cents = integerPart * DECIMAL_SCALE + fraction + (roundUp ? 1 : 0);
+    if (negative) cents = -cents;
+    return true;
+}
+
+ElementType parseValue(const string& value, const string& type) {
+    if (type == "int") {
+        return stoi(value);
+    } else if (type == "float") {
+        return stof(value);
+    } else if (type == "bool") {
+        if (value == "true" || value == "1") return true;
+        if (value == "false" || value == "0") return false;
+        throw invalid_argument("Valor inválido para bool: " + value);
+    } else if (type == "string") {
+        return value;
+    } else if (type == "decimal") {
+        long long cents;
+        if (!parseDecimal(value, cents)) throw invalid_argument("Decimal inválido: " + value);
+        return cents;
+    } else if (type == "date") {
+        int64_t days;
+        if (!parse_date(value, days)) throw invalid_argument("Data inválida: " + value);
+        return static_cast<int>(days);
+    } else if (type == "time") {
+        long long micros;
+        if (!parse_time_micros(value, 0, micros)) throw invalid_argument("Horário inválido: " + value);
+        return micros;
+    } else if (type == "timestamp") {
+        long long micros;
+        if (!parse_timestamp(value, micros)) throw invalid_argument("Timestamp inválido: " + value);
+        return micros;
+    }
+    throw invalid_argument("Tipo de dado desconhecido: " + type);
+}
 
 // Construtor
 DataFrame::DataFrame(const vector<string>& colNamesRef, const vector<string>& colTypesRef)
@@ -36,30 +104,89 @@ DataFrame::DataFrame(const vector<string>& colNamesRef, const vector<string>& co
 
     // Adição de colunas vazias 
     columns.resize(numCols);
-    columnMutexes.resize(numCols);
-    rowMutexes.resize(numRecords);
 }
 
 DataFrame::DataFrame(const DataFrame& other) {
+    // Blocos publicados e ainda não consolidados também são copiados
+    other.consolidate();
     lock_guard<mutex> lock(other.mutexDF); 
 
-    // Copiando os dados
+    // Copiando os dados; as colunas passam a ser compartilhadas (copy-on-write)
     columns = other.columns;
     numRecords = other.numRecords;
     numCols = other.numCols;
     colNames = other.colNames;
     idxColumns = other.idxColumns;
     colTypes = other.colTypes;
+}
+
+DataFrame::DataFrame(DataFrame&& other) noexcept {
+    lock_guard<mutex> lock(other.mutexDF);
+
+    // Transferência dos dados, sem cópia das colunas
+    columns = move(other.columns);
+    numRecords = other.numRecords;
+    numCols = other.numCols;
+    colNames = move(other.colNames);
+    idxColumns = move(other.idxColumns);
+    colTypes = move(other.colTypes);
+    stagedChunks.store(other.stagedChunks.exchange(nullptr));
+
+    other.numRecords = 0;
+    other.numCols = 0;
+    other.version++;
+}
+
+DataFrame& DataFrame::operator=(DataFrame&& other) noexcept {
+    if (this == &other) return *this;
+    scoped_lock lock(mutexDF, other.mutexDF);
 
-    // Novos Mutex
-    columnMutexes = deque<mutex>(other.columnMutexes.size());
-    rowMutexes = deque<mutex>(other.rowMutexes.size());
+    freeStagedChunks();
+    columns = move(other.columns);
+    numRecords = other.numRecords;
+    numCols = other.numCols;
+    colNames = move(other.colNames);
+    idxColumns = move(other.idxColumns);
+    colTypes = move(other.colTypes);
+    stagedChunks.store(other.stagedChunks.exchange(nullptr));
+    version++;
+
+    other.numRecords = 0;
+    other.numCols = 0;
+    other.version++;
+    return *this;
+}
+
+DataFrame& DataFrame::operator=(const DataFrame& other) {
+    if (this == &other) return *this;
+    other.consolidate();
+    scoped_lock lock(mutexDF, other.mutexDF);
+
+    freeStagedChunks();
+    columns = other.columns;
+    numRecords = other.numRecords;
+    numCols = other.numCols;
+    colNames = other.colNames;
+    idxColumns = other.idxColumns;
+    colTypes = other.colTypes;
+    version++;
+    return *this;
 }
 
+void DataFrame::freeStagedChunks() {
+    // Descarta os blocos publicados e nunca consolidados
+    for (ColumnChunk* chunk = stagedChunks.exchange(nullptr); chunk; ) {
+        ColumnChunk* next = chunk->next;
+        delete chunk;
+        chunk = next;
+    }
+}
 
 // Destrutor
 DataFrame::~DataFrame()
 {
+    freeStagedChunks();
+
     lock_guard<mutex> lock(mutexDF);
 
     columns.clear();
@@ -72,14 +199,14 @@ DataFrame::~DataFrame()
 }
 
 
-void DataFrame::addColumn(const vector<ElementType>& col, string colName, string colType)
+void DataFrame::addColumn(Column col, string colName, string colType)
 {
+    consolidate();
     lock_guard<mutex> lock(mutexDF);
 
     // Se ainda não há registros, definimos com base nessa coluna
     if (numRecords == 0) {
         numRecords = col.size();
-        rowMutexes.resize(numRecords);  // importante para evitar problemas futuros
     } else if (numRecords != col.size()) {
         cerr << "Número de registros incompatível" << endl;
         return;
@@ -87,10 +214,11 @@ void DataFrame::addColumn(const vector<ElementType>& col, string colName, string
 
     // Se a coluna já existe, atualizamos ela
     if (colTypes.find(colName) != colTypes.end() && colTypes[colName] == colType){
-        // Atualização da coluna existente
+        // Atualização da coluna existente: troca o buffer, cópias anteriores do DataFrame
+        // continuam com os valores antigos
         int idx = idxColumns[colName];
-        //lock_guard<mutex> colLock(columnMutexes[idx]);
-        columns[idx] = col;
+        columns[idx] = move(col);
+        version++;
         return;
     }
     
@@ -99,8 +227,8 @@ void DataFrame::addColumn(const vector<ElementType>& col, string colName, string
     colNames.push_back(colName);
     idxColumns[colName] = numCols-1;  
     colTypes[colName] = colType;
-    columns.push_back(col);
-    columnMutexes.emplace_back(); 
+    columns.push_back(move(col));
+    version++;
 }
 
 
@@ -119,7 +247,6 @@ void DataFrame::addRecord(const vector<string>& record) {
     vector<ElementType> newRecord(numCols);
     
     for (size_t i = 0; i < record.size(); i++) {
-        // lock_guard<mutex> colLock(columnMutexes[i]); 
         const string& type = colTypes[colNames[i]];
         const string& value = record[i];
         
@@ -137,27 +264,43 @@ void DataFrame::addRecord(const vector<string>& record) {
             }
         } else if (type == "string") {
             newRecord[i] = (value);
+        } else if (type == "decimal" || type == "date" || type == "time" || type == "timestamp") {
+            newRecord[i] = parseValue(value, type);
         } else {
             throw invalid_argument("Tipo de dado desconhecido na coluna " + colNames[i]);
         }
     }
     
+    consolidate();
     lock_guard<mutex> lock(mutexDF);
     for(size_t i = 0; i < numCols; i++) {
-        // lock_guard<mutex> colLock(columnMutexes[i]); 
+        // push_back copia antes a coluna, se ela for compartilhada com outra cópia do DataFrame
         columns[i].push_back(newRecord[i]);
     }
     numRecords++;
-    rowMutexes.emplace_back();
+    version++;
 }
 
 void DataFrame::addMultipleRecords(const vector<vector<string>>& records) {
+    addMultipleRecords(records, UNORDERED_CHUNK);
+}
+
+void DataFrame::addMultipleRecords(const vector<vector<string>>& records, size_t sequence) {
+    /*
+    Converte um bloco de registros em colunas locais e o publica com appendChunk, sem
+    travar o DataFrame: vários produtores podem converter e publicar blocos ao mesmo
+    tempo. Os registros passam para columns em consolidate(), na ordem de sequence.
+    */
     if (records.empty()) {
         cerr << "Nenhum registro para adicionar." << endl;
         return;
     }
     int numRecordsToAdd = records.size();
 
+    // Tipos lidos uma vez por bloco (o mapa de tipos não é alterado aqui)
+    vector<string> types(numCols);
+    for (int j = 0; j < numCols; ++j) types[j] = colTypes.at(colNames[j]);
+
     vector<vector<ElementType>> newRecords(numCols, vector<ElementType>(numRecordsToAdd));
     for (int i = 0; i < numRecordsToAdd; ++i) {
         if (records[i].size() != numCols) {
@@ -165,7 +308,7 @@ void DataFrame::addMultipleRecords(const vector<vector<string>>& records) {
             return;
         }
         for (int j = 0; j < numCols; ++j) {
-            const string& type = colTypes[colNames[j]];
+            const string& type = types[j];
             const string& value = records[i][j];
 
             if (type == "int") {
@@ -176,6 +319,8 @@ void DataFrame::addMultipleRecords(const vector<vector<string>>& records) {
                 newRecords[j][i] = (value == "true" || value == "1");
             } else if (type == "string") {
                 newRecords[j][i] = value;
+            } else if (type == "decimal" || type == "date" || type == "time" || type == "timestamp") {
+                newRecords[j][i] = parseValue(value, type);
             } else {
                 cerr << "Tipo de dado desconhecido na coluna " << colNames[j] << endl;
                 return;
@@ -183,17 +328,77 @@ void DataFrame::addMultipleRecords(const vector<vector<string>>& records) {
         }
     }
 
+    appendChunk(move(newRecords), sequence);
+}
+
+void DataFrame::appendChunk(vector<vector<ElementType>>&& chunkColumns, size_t sequence) {
+    /*
+    Empilha o bloco na lista de blocos publicados com compare-and-swap: nenhum lock
+    e nenhuma realocação das colunas existentes.
+    */
+    if (chunkColumns.size() != static_cast<size_t>(numCols)) {
+        cerr << "Número de colunas do bloco incompatível" << endl;
+        return;
+    }
+    size_t chunkRecords = chunkColumns.empty() ? 0 : chunkColumns[0].size();
+    for (const auto& column : chunkColumns) {
+        if (column.size() != chunkRecords) {
+            cerr << "Número de registros incompatível" << endl;
+            return;
+        }
+    }
+
+    ColumnChunk* chunk = new ColumnChunk{move(chunkColumns), chunkRecords, sequence, nullptr};
+    chunk->next = stagedChunks.load(memory_order_relaxed);
+    // Em caso de disputa, compare_exchange_weak recarrega o topo atual em chunk->next
+    while (!stagedChunks.compare_exchange_weak(chunk->next, chunk, memory_order_release, memory_order_relaxed)) {}
+}
+
+void DataFrame::consolidate() const {
+    /*
+    Retira de uma vez todos os blocos publicados e os acrescenta às colunas ordenados pela
+    sequência de cada bloco, então a ordem das linhas é a da fonte independentemente de
+    qual thread terminou primeiro. Cada coluna é realocada uma única vez, já no tamanho
+    final, e os valores são movidos (strings não são copiadas).
+    */
+    if (!stagedChunks.load(memory_order_acquire)) return;
+
+    // O lock vem antes da retirada dos blocos: quem chega depois espera a consolidação terminar
     lock_guard<mutex> lock(mutexDF);
-    for(int j = 0; j < numCols; ++j) {
-        // lock_guard<mutex> colLock(columnMutexes[j]); 
-        columns[j].insert(columns[j].end(), newRecords[j].begin(), newRecords[j].end());
+    ColumnChunk* chunk = stagedChunks.exchange(nullptr, memory_order_acquire);
+    if (!chunk) return;
+
+    // A pilha guarda o último bloco publicado no topo
+    vector<ColumnChunk*> chunks;
+    size_t added = 0;
+    for (; chunk; chunk = chunk->next) {
+        chunks.push_back(chunk);
+        added += chunk->numRecords;
+    }
+    reverse(chunks.begin(), chunks.end());
+    stable_sort(chunks.begin(), chunks.end(), [](const ColumnChunk* a, const ColumnChunk* b) {
+        return a->sequence < b->sequence;
+    });
+
+    for (int j = 0; j < numCols; ++j) {
+        // reserve copia antes a coluna, se ela for compartilhada com outra cópia do DataFrame
+        columns[j].reserve(numRecords + added);
+        vector<ElementType>& values = columns[j].mutableValues();
+        for (ColumnChunk* staged : chunks) {
+            auto& source = staged->columns[j];
+            values.insert(values.end(), make_move_iterator(source.begin()), make_move_iterator(source.end()));
+            vector<ElementType>().swap(source);
+        }
     }
-    numRecords += numRecordsToAdd;
-    rowMutexes.resize(numRecords);  // Atualiza o tamanho do vetor de mutexes de linha
+    for (ColumnChunk* staged : chunks) delete staged;
+
+    numRecords += added;
+    version++;
 }
 
 
 DataFrame DataFrame::getRecords(const vector<int>& indexes) const {
+    consolidate();
     lock_guard<mutex> lock(mutexDF);
 
     int qtdIndices = indexes.size();
@@ -207,7 +412,15 @@ DataFrame DataFrame::getRecords(const vector<int>& indexes) const {
     // Novo df com os tipos corretos
     DataFrame dfResult(colNames, tipos);
     dfResult.columns.resize(numCols);
-    dfResult.columnMutexes.resize(numCols);  
+
+    // Todas as linhas, em ordem: o resultado compartilha as colunas, sem cópia
+    bool allRows = qtdIndices == numRecords;
+    for (int i = 0; allRows && i < qtdIndices; ++i) allRows = indexes[i] == i;
+    if (allRows) {
+        dfResult.columns = columns;
+        dfResult.numRecords = numRecords;
+        return dfResult;
+    }
 
     // Cópia das linhas
     for (int idx : indexes) {
@@ -221,7 +434,6 @@ DataFrame DataFrame::getRecords(const vector<int>& indexes) const {
         }
 
         dfResult.numRecords++;  
-        dfResult.rowMutexes.emplace_back();
     }
 
     return dfResult;
@@ -231,6 +443,7 @@ void DataFrame::printDF(){
     /* 
     Realiza o print de um DataFrame. 
     */
+   consolidate();
    lock_guard<mutex> lock(mutexDF);
 
     if (numRecords == 0) {
@@ -238,6 +451,7 @@ void DataFrame::printDF(){
         return;
     }
 
+    // Leituras por values(): não copiam colunas compartilhadas com outras cópias do DataFrame
     vector<int> colWidths(numCols, 0);
 
     // Calcula a largura máxima de cada coluna 
@@ -246,7 +460,7 @@ void DataFrame::printDF(){
         colWidths[j] = colNames[j].size();
         
         for (size_t i = 0; i < numRecords; i++) {
-            int width = variantToString(columns[j][i]).size();
+            int width = formatValue(columns[j].values()[i], colTypes[colNames[j]]).size();
             if (width > colWidths[j]) {
                 colWidths[j] = width;
             }
@@ -275,7 +489,7 @@ void DataFrame::printDF(){
     for (size_t i = 0; i < numRecords; i++) {
         cout << "|";
         for (size_t j = 0; j < numCols; j++) {
-            cout << " " << setw(colWidths[j]) << left << variantToString(columns[j][i]) << " |";
+            cout << " " << setw(colWidths[j]) << left << formatValue(columns[j].values()[i], colTypes[colNames[j]]) << " |";
         }
         cout << endl;
     }
@@ -284,53 +498,172 @@ void DataFrame::printDF(){
     // unlock()
 }
 
-void DataFrame::DFtoCSV(string csvName) {
+// Como cada coluna é escrita no CSV: formato dos valores e se vai entre aspas (colunas string)
+struct CSVColumn {
+    ValueFormat format;
+    bool quoted;
+};
+
+static void formatCSVRows(const vector<Column>& columns, const vector<CSVColumn>& layout, size_t start, size_t end, string& out) {
+    /*Acrescenta as linhas [start, end) em formato CSV ao fim de out.*/
+    for (size_t row = start; row < end; ++row) {
+        for (size_t col = 0; col < layout.size(); ++col) {
+            const ElementType& value = columns[col][row];
+            if (layout[col].quoted) {
+                // Aspas em torno de strings e escape de aspas internas (duplicadas)
+                out += '"';
+                size_t valueStart = out.size();
+                appendValue(out, value, layout[col].format);
+                if (out.find('"', valueStart) != string::npos) {
+                    string escaped;
+                    for (size_t pos = valueStart; pos < out.size(); ++pos) {
+                        if (out[pos] == '"') escaped += '"';
+                        escaped += out[pos];
+                    }
+                    out.replace(valueStart, string::npos, escaped);
+                }
+                out += '"';
+            } else {
+                appendValue(out, value, layout[col].format);
+            }
+            out += col + 1 < layout.size() ? ',' : '\n';
+        }
+    }
+}
+
+static vector<CSVColumn> csvLayout(const vector<string>& colNames, unordered_map<string, string>& colTypes) {
+    vector<CSVColumn> layout;
+    for (const auto& name : colNames) {
+        layout.push_back({valueFormatFor(colTypes[name]), colTypes[name] == "string"});
+    }
+    return layout;
+}
+
+static void writeCSVRows(ofstream& outFile, const vector<Column>& columns, const vector<CSVColumn>& layout, size_t totalRecords) {
+    /*Formata e escreve as linhas em blocos de CSV_BLOCK_ROWS, reaproveitando um único buffer.*/
+    string buffer;
+    for (size_t start = 0; start < totalRecords; start += DataFrame::CSV_BLOCK_ROWS) {
+        buffer.clear();
+        formatCSVRows(columns, layout, start, min(start + DataFrame::CSV_BLOCK_ROWS, totalRecords), buffer);
+        outFile.write(buffer.data(), buffer.size());
+    }
+}
+
+static void writeCSVRowsParallel(ofstream& outFile, const vector<Column>& columns, const vector<CSVColumn>& layout, size_t totalRecords, int id, int numThreads, ThreadPool& pool) {
+    /*Parte paralela de DFtoCSV: blocos formatados pelo pool e escritos em ordem.*/
+    size_t numBlocks = (totalRecords + DataFrame::CSV_BLOCK_ROWS - 1) / DataFrame::CSV_BLOCK_ROWS;
+    size_t window = 2 * static_cast<size_t>(numThreads);
+
+    // Janela deslizante: enquanto um bloco é escrito, os seguintes continuam sendo formatados
+    deque<future<string>> pending;
+    size_t nextBlock = 0;
+    auto enqueueBlock = [&]() {
+        size_t start = nextBlock++ * DataFrame::CSV_BLOCK_ROWS;
+        size_t end = min(start + DataFrame::CSV_BLOCK_ROWS, totalRecords);
+        pending.push_back(pool.enqueue(-id, [&columns, &layout, start, end]() {
+            string buffer;
+            formatCSVRows(columns, layout, start, end, buffer);
+            return buffer;
+        }));
+    };
+
+    while (nextBlock < numBlocks && pending.size() < window) enqueueBlock();
+    pool.isReady(-id);
+
+    try {
+        while (!pending.empty()) {
+            string buffer = pending.front().get();
+            pending.pop_front();
+            if (nextBlock < numBlocks) {
+                enqueueBlock();
+                pool.isReady(-id);
+            }
+            outFile.write(buffer.data(), buffer.size());
+        }
+    } catch (...) {
+        // As tarefas na fila usam layout e as colunas: espera todas antes de propagar
+        for (auto& f : pending) f.wait();
+        throw;
+    }
+}
+
+static string csvHeader(const vector<string>& colNames) {
+    string header;
+    for (size_t i = 0; i < colNames.size(); ++i) {
+        header += colNames[i];
+        header += i + 1 < colNames.size() ? ',' : '\n';
+    }
+    return header;
+}
+
+bool DataFrame::DFtoCSV(string csvName) {
     /* 
     Realiza a conversão do objeto DataFrame para CSV.
+    As linhas são formatadas em blocos de CSV_BLOCK_ROWS em um buffer, escrito de uma vez.
     */
 
+    consolidate();
     lock_guard<mutex> lock(mutexDF);
 
     ofstream outFile(csvName + ".csv");
     if (!outFile.is_open()) {
         cerr << "Erro ao abrir o arquivo para escrita." << endl;
-        return;
+        return false;
     }
 
     // Escrita do nome das colunas
-    for (int i = 0; i < numCols; ++i) {
-        outFile << colNames[i];
-        if (i < numCols - 1) 
-            outFile << ",";
-    }
-    outFile << "\n";
-
-    // Escrita dos dados das linhas
-    for (int row = 0; row < numRecords; ++row) {
-        for (int col = 0; col < numCols; ++col) {
-            string valStr = variantToString(columns[col][row]);
-
-            // Aspas em torno de strings e escape de aspas internas
-            if (colTypes[colNames[col]] == "string") {
-                for (size_t pos = 0; (pos = valStr.find('"', pos)) != string::npos; pos += 2) {
-                    valStr.insert(pos, "\""); // duplica aspas internas
-                }
-                outFile << "\"" << valStr << "\"";
-            } else {
-                outFile << valStr;
-            }
+    string header = csvHeader(colNames);
+    outFile.write(header.data(), header.size());
 
-            // Adição do separador ","
-            if (col < numCols - 1) 
-                outFile << ",";
-        }
-        outFile << "\n";
+    // Escrita dos dados das linhas (leitura sem copiar colunas compartilhadas)
+    writeCSVRows(outFile, columns, csvLayout(colNames, colTypes), numRecords);
+
+    outFile.close();
+    if (!outFile) {
+        cerr << "Erro ao escrever o arquivo " << csvName << ".csv" << endl;
+        return false;
+    }
+    return true;
+}
+
+bool DataFrame::DFtoCSV(string csvName, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Versão paralela de DFtoCSV: cada bloco de CSV_BLOCK_ROWS linhas é formatado por uma
+    tarefa do pool em um buffer próprio, e os buffers são escritos em ordem assim que ficam
+    prontos. No máximo 2 * numThreads blocos ficam em memória ao mesmo tempo.
+    */
+    consolidate();
+    lock_guard<mutex> lock(mutexDF);
+    size_t totalRecords = numRecords;
+
+    ofstream outFile(csvName + ".csv");
+    if (!outFile.is_open()) {
+        cerr << "Erro ao abrir o arquivo para escrita." << endl;
+        return false;
+    }
+
+    string header = csvHeader(colNames);
+    outFile.write(header.data(), header.size());
+
+    vector<CSVColumn> layout = csvLayout(colNames, colTypes);
+    if (numThreads < 2 || totalRecords <= CSV_BLOCK_ROWS) {
+        writeCSVRows(outFile, columns, layout, totalRecords);
+    } else {
+        writeCSVRowsParallel(outFile, columns, layout, totalRecords, id, numThreads, pool);
     }
 
     outFile.close();
+    if (!outFile) {
+        cerr << "Erro ao escrever o arquivo " << csvName << ".csv" << endl;
+        return false;
+    }
+    return true;
 }
 
+
 vector<ElementType> DataFrame::getRecord(int i) const {
+    consolidate();
+    lock_guard<mutex> lock(mutexDF);
     vector<ElementType> record;
     for (int j = 0; j < numCols; ++j) {
         record.push_back(columns[j][i]);
@@ -351,7 +684,9 @@ int DataFrame::getNumCols() const {
     return numCols;
 }
 
-vector<ElementType> DataFrame::getColumn(int i) const {
+Column DataFrame::getColumn(int i) const {
+    consolidate();
+    lock_guard<mutex> lock(mutexDF);
     return columns[i];
 }
 
@@ -366,6 +701,8 @@ string DataFrame::getColumnType(int idxColumn) const {
 }
 
 int DataFrame::getNumRecords() const {
+    consolidate();
+    lock_guard<mutex> lock(mutexDF);
     return numRecords;
 }
 
@@ -401,6 +738,7 @@ void DataFrame::changeColumnName(string pastName, string newName) {
         colTypes.erase(pastName);
         colTypes[newName] = type;
     }
+    version++;
 }
 
 // //Driver Code Test
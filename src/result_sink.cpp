@@ -0,0 +1,91 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include "../include/result_sink.h"
+#include "../include/snapshot.h"
+#include "../include/arrow_ipc.h"
+
+using namespace std;
+
+ResultSink::ResultSink(int id, int numThreads, ThreadPool& pool, size_t maxPendingCells)
+    : id(id), numThreads(numThreads), pool(pool), maxPendingCells(maxPendingCells) {
+    writer = thread([this]() { run(); });
+}
+
+ResultSink::~ResultSink() {
+    {
+        lock_guard<mutex> lock(mtx);
+        stop = true;
+    }
+    jobReady.notify_all();
+    if (writer.joinable()) writer.join();
+}
+
+void ResultSink::submit(const DataFrame& df, const string& basePath, int formats) {
+    submit(make_shared<DataFrame>(df), basePath, formats);
+}
+
+void ResultSink::submit(DataFramePtr df, const string& basePath, int formats) {
+    /*
+    Enfileira um resultado para a thread de escrita. Se as células pendentes passam do
+    limite, espera escritas anteriores terminarem antes de enfileirar.
+    */
+    if (!df) {
+        cerr << "Resultado nulo enviado para escrita em " << basePath << endl;
+        failures++;
+        return;
+    }
+    size_t cells = static_cast<size_t>(df->getNumRecords()) * df->getNumCols();
+
+    unique_lock<mutex> lock(mtx);
+    spaceFreed.wait(lock, [&]() {
+        return pendingCells == 0 || pendingCells + cells <= maxPendingCells;
+    });
+    pendingCells += cells;
+    jobs.push({move(df), basePath, formats, cells});
+    lock.unlock();
+    jobReady.notify_one();
+}
+
+void ResultSink::flush() {
+    unique_lock<mutex> lock(mtx);
+    spaceFreed.wait(lock, [&]() { return jobs.empty() && !writing; });
+}
+
+void ResultSink::run() {
+    /*Laço da thread de escrita: escreve os resultados na ordem em que foram enfileirados.*/
+    while (true) {
+        Job job;
+        {
+            unique_lock<mutex> lock(mtx);
+            jobReady.wait(lock, [&]() { return stop || !jobs.empty(); });
+            if (jobs.empty()) return;   // stop, com a fila já esvaziada
+            job = move(jobs.front());
+            jobs.pop();
+            writing = true;
+        }
+
+        write(job);
+        size_t cells = job.cells;
+        job.df.reset();                 // Libera o resultado antes de abrir espaço na fila
+
+        {
+            lock_guard<mutex> lock(mtx);
+            pendingCells -= cells;
+            writing = false;
+        }
+        spaceFreed.notify_all();
+    }
+}
+
+void ResultSink::write(Job& job) {
+    if (job.formats & SINK_CSV) {
+        if (!job.df->DFtoCSV(job.basePath, id, numThreads, pool)) failures++;
+    }
+    if (job.formats & SINK_SNAPSHOT) {
+        if (!writeSnapshot(*job.df, job.basePath + ".dfsnap")) failures++;
+    }
+    if (job.formats & SINK_ARROW) {
+        if (!writeArrow(*job.df, job.basePath + ".arrow")) failures++;
+    }
+}
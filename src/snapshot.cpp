@@ -0,0 +1,461 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <unordered_map>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include "../include/df.h"
+#include "../include/df_builder.h"
+#include "../include/snapshot.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+using ElementType = variant<int, float, bool, string, long long>; // Tipo possível das variáveis
+
+static const char SNAPSHOT_MAGIC[8] = {'D', 'F', 'S', 'N', 'A', 'P', '\0', '\1'};
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+static const size_t HEADER_SIZE = 32;
+
+// Codificação de uma coluna: o índice do tipo no variant (todos os valores do mesmo tipo) ou MIXED
+static const uint8_t MIXED_ENCODING = 255;
+
+static uint64_t checksum64(const char* data, size_t size) {
+    /*Checksum de 64 bits, misturando 8 bytes por vez; serve para detectar arquivos corrompidos.*/
+    uint64_t hash = 0x9E3779B97F4A7C15ULL ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 31;
+    }
+    uint64_t tail = 0;
+    if (size > i) memcpy(&tail, data + i, size - i);
+    hash = (hash ^ tail) * 0x94D049BB133111EBULL;
+    return hash ^ (hash >> 29);
+}
+
+static size_t align8(size_t size) {
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+// Escrita de valores e trechos brutos no fim de um buffer
+template <typename T>
+static void appendValue(vector<char>& out, T value) {
+    size_t pos = out.size();
+    out.resize(pos + sizeof(T));
+    memcpy(out.data() + pos, &value, sizeof(T));
+}
+
+static void appendBytes(vector<char>& out, const char* data, size_t size) {
+    out.insert(out.end(), data, data + size);
+}
+
+static void padTo8(vector<char>& out) {
+    out.resize(align8(out.size()), 0);
+}
+
+static void appendStringTable(vector<char>& out, const vector<string_view>& strings) {
+    // Tabela de strings: deslocamentos (d + 1) e blob com as strings concatenadas
+    uint64_t offset = 0;
+    appendValue<uint64_t>(out, offset);
+    for (string_view text : strings) {
+        offset += text.size();
+        appendValue<uint64_t>(out, offset);
+    }
+    for (string_view text : strings) appendBytes(out, text.data(), text.size());
+    padTo8(out);
+}
+
+static vector<char> encodeColumn(const vector<ElementType>& values, uint8_t& encoding) {
+    /*
+    Codifica uma coluna no buffer tipado do seu tipo. Strings viram um dicionário
+    (códigos u32 + tabela de strings distintas). Colunas com valores de tipos
+    diferentes usam a codificação MIXED (tag + payload de 8 bytes por valor).
+    */
+    size_t n = values.size();
+    encoding = n == 0 ? 0 : static_cast<uint8_t>(values[0].index());
+    for (const auto& value : values) {
+        if (value.index() != encoding) {
+            encoding = MIXED_ENCODING;
+            break;
+        }
+    }
+
+    vector<char> out;
+    switch (encoding) {
+        case 0:
+            out.reserve(n * sizeof(int32_t));
+            for (const auto& value : values) appendValue<int32_t>(out, get<int>(value));
+            break;
+        case 1:
+            out.reserve(n * sizeof(float));
+            for (const auto& value : values) appendValue<float>(out, get<float>(value));
+            break;
+        case 2:
+            out.reserve(n);
+            for (const auto& value : values) appendValue<uint8_t>(out, get<bool>(value) ? 1 : 0);
+            break;
+        case 4:
+            out.reserve(n * sizeof(int64_t));
+            for (const auto& value : values) appendValue<int64_t>(out, get<long long>(value));
+            break;
+        case 3: {
+            unordered_map<string_view, uint32_t> codes;
+            vector<string_view> dictionary;
+            vector<uint32_t> rowCodes(n);
+            for (size_t i = 0; i < n; ++i) {
+                string_view text = get<string>(values[i]);
+                auto inserted = codes.emplace(text, static_cast<uint32_t>(dictionary.size()));
+                if (inserted.second) dictionary.push_back(text);
+                rowCodes[i] = inserted.first->second;
+            }
+            appendValue<uint64_t>(out, dictionary.size());
+            appendBytes(out, reinterpret_cast<const char*>(rowCodes.data()), n * sizeof(uint32_t));
+            padTo8(out);
+            appendStringTable(out, dictionary);
+            break;
+        }
+        default: {
+            vector<string_view> strings;
+            for (const auto& value : values) appendValue<uint8_t>(out, static_cast<uint8_t>(value.index()));
+            padTo8(out);
+            for (const auto& value : values) {
+                int64_t payload = 0;
+                if (const int* i = get_if<int>(&value)) payload = *i;
+                else if (const float* f = get_if<float>(&value)) {
+                    uint32_t bits;
+                    memcpy(&bits, f, sizeof(bits));
+                    payload = bits;
+                }
+                else if (const bool* b = get_if<bool>(&value)) payload = *b ? 1 : 0;
+                else if (const long long* l = get_if<long long>(&value)) payload = *l;
+                else {
+                    payload = static_cast<int64_t>(strings.size());
+                    strings.push_back(get<string>(value));
+                }
+                appendValue<int64_t>(out, payload);
+            }
+            appendValue<uint64_t>(out, strings.size());
+            appendStringTable(out, strings);
+            break;
+        }
+    }
+    padTo8(out);
+    return out;
+}
+
+bool writeSnapshot(const DataFrame& df, const string& filename) {
+    /*
+    Escreve o DataFrame no formato de snapshot. O arquivo é escrito em filename.tmp e
+    renomeado no fim, então leitores nunca veem um snapshot pela metade.
+    */
+    size_t numCols = df.getNumCols();
+    uint64_t numRecords = df.getNumRecords();
+
+    vector<vector<char>> buffers(numCols);
+    vector<uint8_t> encodings(numCols);
+    for (size_t j = 0; j < numCols; ++j) {
+        buffers[j] = encodeColumn(df.columns[j].values(), encodings[j]);
+    }
+
+    // Esquema, com os deslocamentos calculados a partir do tamanho dele
+    size_t schemaSize = 0;
+    for (size_t j = 0; j < numCols; ++j) {
+        schemaSize += 1 + 4 + df.getColumnName(j).size() + 4 + df.getColumnType(j).size() + 3 * 8;
+    }
+    uint64_t offset = align8(HEADER_SIZE + schemaSize + sizeof(uint64_t));
+
+    vector<char> header;
+    appendBytes(header, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    appendValue<uint32_t>(header, SNAPSHOT_VERSION);
+    appendValue<uint32_t>(header, BYTE_ORDER_MARK);
+    appendValue<uint64_t>(header, numRecords);
+    appendValue<uint32_t>(header, static_cast<uint32_t>(numCols));
+    appendValue<uint32_t>(header, static_cast<uint32_t>(schemaSize));
+    for (size_t j = 0; j < numCols; ++j) {
+        string name = df.getColumnName(j);
+        string type = df.getColumnType(j);
+        appendValue<uint8_t>(header, encodings[j]);
+        appendValue<uint32_t>(header, static_cast<uint32_t>(name.size()));
+        appendBytes(header, name.data(), name.size());
+        appendValue<uint32_t>(header, static_cast<uint32_t>(type.size()));
+        appendBytes(header, type.data(), type.size());
+        appendValue<uint64_t>(header, offset);
+        appendValue<uint64_t>(header, buffers[j].size());
+        appendValue<uint64_t>(header, checksum64(buffers[j].data(), buffers[j].size()));
+        offset += buffers[j].size();
+    }
+    appendValue<uint64_t>(header, checksum64(header.data(), header.size()));
+    padTo8(header);
+
+    string tmpName = filename + ".tmp";
+    ofstream outFile(tmpName, ios::binary | ios::trunc);
+    if (!outFile.is_open()) {
+        cerr << "Erro ao abrir o arquivo para escrita: " << tmpName << endl;
+        return false;
+    }
+    outFile.write(header.data(), header.size());
+    for (const auto& buffer : buffers) outFile.write(buffer.data(), buffer.size());
+    outFile.close();
+    if (!outFile) {
+        cerr << "Erro ao escrever o snapshot: " << tmpName << endl;
+        remove(tmpName.c_str());
+        return false;
+    }
+
+    if (rename(tmpName.c_str(), filename.c_str()) != 0) {
+        cerr << "Erro ao renomear o snapshot para " << filename << endl;
+        remove(tmpName.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Leitura sequencial de um trecho do arquivo com verificação de limites
+struct SnapshotReader {
+    const char* data;
+    size_t size;
+    size_t pos = 0;
+    bool ok = true;
+
+    const char* take(size_t n) {
+        if (!ok || n > size - pos) {
+            ok = false;
+            return nullptr;
+        }
+        const char* ptr = data + pos;
+        pos += n;
+        return ptr;
+    }
+
+    template <typename T>
+    T read() {
+        T value{};
+        if (const char* ptr = take(sizeof(T))) memcpy(&value, ptr, sizeof(T));
+        return value;
+    }
+
+    string readString() {
+        uint32_t length = read<uint32_t>();
+        const char* ptr = take(length);
+        return ptr ? string(ptr, length) : string();
+    }
+
+    void skipPadding() {
+        size_t aligned = align8(pos);
+        if (aligned > size) ok = false;
+        else pos = aligned;
+    }
+};
+
+template <typename T>
+static T loadAt(const char* base, size_t i) {
+    T value;
+    memcpy(&value, base + i * sizeof(T), sizeof(T));
+    return value;
+}
+
+static bool readStringTable(SnapshotReader& reader, uint64_t count, vector<string>& strings) {
+    // Lê os deslocamentos e o blob de uma tabela de strings com count entradas
+    if (count > reader.size / sizeof(uint64_t)) return false;
+    const char* offsets = reader.take((count + 1) * sizeof(uint64_t));
+    if (!offsets) return false;
+    uint64_t blobSize = loadAt<uint64_t>(offsets, count);
+    const char* blob = reader.take(blobSize);
+    if (!blob) return false;
+
+    strings.resize(count);
+    for (uint64_t d = 0; d < count; ++d) {
+        uint64_t begin = loadAt<uint64_t>(offsets, d);
+        uint64_t end = loadAt<uint64_t>(offsets, d + 1);
+        if (begin > end || end > blobSize) return false;
+        strings[d].assign(blob + begin, end - begin);
+    }
+    return true;
+}
+
+static bool decodeColumn(const char* data, size_t size, uint8_t encoding, size_t n, ColumnBuilder& column) {
+    /*Decodifica o buffer de uma coluna direto no builder; false se o buffer for inválido.*/
+    SnapshotReader reader{data, size};
+    switch (encoding) {
+        case 0: {
+            const char* values = reader.take(n * sizeof(int32_t));
+            if (!values) return false;
+            for (size_t i = 0; i < n; ++i) column.set(i, static_cast<int>(loadAt<int32_t>(values, i)));
+            return true;
+        }
+        case 1: {
+            const char* values = reader.take(n * sizeof(float));
+            if (!values) return false;
+            for (size_t i = 0; i < n; ++i) column.set(i, loadAt<float>(values, i));
+            return true;
+        }
+        case 2: {
+            const char* values = reader.take(n);
+            if (!values) return false;
+            for (size_t i = 0; i < n; ++i) column.set(i, values[i] != 0);
+            return true;
+        }
+        case 4: {
+            const char* values = reader.take(n * sizeof(int64_t));
+            if (!values) return false;
+            for (size_t i = 0; i < n; ++i) column.set(i, static_cast<long long>(loadAt<int64_t>(values, i)));
+            return true;
+        }
+        case 3: {
+            uint64_t count = reader.read<uint64_t>();
+            const char* codes = reader.take(n * sizeof(uint32_t));
+            reader.skipPadding();
+            vector<string> dictionary;
+            if (!codes || !reader.ok || !readStringTable(reader, count, dictionary)) return false;
+            for (size_t i = 0; i < n; ++i) {
+                uint32_t code = loadAt<uint32_t>(codes, i);
+                if (code >= dictionary.size()) return false;
+                column.set(i, dictionary[code]);
+            }
+            return true;
+        }
+        case MIXED_ENCODING: {
+            const char* tags = reader.take(n);
+            reader.skipPadding();
+            const char* payloads = reader.take(n * sizeof(int64_t));
+            uint64_t count = reader.read<uint64_t>();
+            vector<string> strings;
+            if (!tags || !payloads || !reader.ok || !readStringTable(reader, count, strings)) return false;
+            for (size_t i = 0; i < n; ++i) {
+                int64_t payload = loadAt<int64_t>(payloads, i);
+                switch (tags[i]) {
+                    case 0: column.set(i, static_cast<int>(payload)); break;
+                    case 1: {
+                        uint32_t bits = static_cast<uint32_t>(payload);
+                        float value;
+                        memcpy(&value, &bits, sizeof(value));
+                        column.set(i, value);
+                        break;
+                    }
+                    case 2: column.set(i, payload != 0); break;
+                    case 3:
+                        if (payload < 0 || static_cast<uint64_t>(payload) >= strings.size()) return false;
+                        column.set(i, strings[payload]);
+                        break;
+                    case 4: column.set(i, static_cast<long long>(payload)); break;
+                    default: return false;
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+static DataFrame* decodeSnapshot(const char* data, size_t size, const string& filename) {
+    /*Confere cabeçalho e checksums e monta o DataFrame a partir dos buffers mapeados.*/
+    SnapshotReader reader{data, size};
+    const char* magic = reader.take(sizeof(SNAPSHOT_MAGIC));
+    uint32_t version = reader.read<uint32_t>();
+    uint32_t byteOrder = reader.read<uint32_t>();
+    uint64_t numRecords = reader.read<uint64_t>();
+    uint32_t numCols = reader.read<uint32_t>();
+    uint32_t schemaSize = reader.read<uint32_t>();
+
+    if (!magic || memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || version != SNAPSHOT_VERSION) {
+        cerr << "Arquivo não é um snapshot de DataFrame válido: " << filename << endl;
+        return nullptr;
+    }
+    if (byteOrder != BYTE_ORDER_MARK) {
+        cerr << "Snapshot escrito em uma máquina com outra ordem de bytes: " << filename << endl;
+        return nullptr;
+    }
+    if (schemaSize > size - reader.pos || reader.pos + schemaSize + sizeof(uint64_t) > size) {
+        cerr << "Snapshot corrompido (esquema): " << filename << endl;
+        return nullptr;
+    }
+    uint64_t headerChecksum;
+    memcpy(&headerChecksum, data + reader.pos + schemaSize, sizeof(headerChecksum));
+    if (headerChecksum != checksum64(data, reader.pos + schemaSize)) {
+        cerr << "Snapshot corrompido (checksum do esquema): " << filename << endl;
+        return nullptr;
+    }
+
+    vector<string> colNames(numCols), colTypes(numCols);
+    vector<uint8_t> encodings(numCols);
+    vector<uint64_t> offsets(numCols), sizes(numCols), checksums(numCols);
+    for (uint32_t j = 0; j < numCols; ++j) {
+        encodings[j] = reader.read<uint8_t>();
+        colNames[j] = reader.readString();
+        colTypes[j] = reader.readString();
+        offsets[j] = reader.read<uint64_t>();
+        sizes[j] = reader.read<uint64_t>();
+        checksums[j] = reader.read<uint64_t>();
+    }
+    if (!reader.ok) {
+        cerr << "Snapshot corrompido (esquema): " << filename << endl;
+        return nullptr;
+    }
+
+    DataFrameBuilder builder(colNames, colTypes, numRecords);
+    for (uint32_t j = 0; j < numCols; ++j) {
+        if (offsets[j] > size || sizes[j] > size - offsets[j] ||
+            checksum64(data + offsets[j], sizes[j]) != checksums[j] ||
+            !decodeColumn(data + offsets[j], sizes[j], encodings[j], numRecords, builder.column(j))) {
+            cerr << "Snapshot corrompido (coluna " << colNames[j] << "): " << filename << endl;
+            return nullptr;
+        }
+    }
+
+    return new DataFrame(builder.finish());
+}
+
+DataFrame* readSnapshot(const string& filename) {
+    /*
+    Lê um snapshot: o arquivo é mapeado em memória (as páginas vêm do page cache e são
+    compartilhadas entre processos que leem o mesmo arquivo) e os buffers tipados são
+    decodificados direto nas colunas, sem conversão de texto.
+    */
+#ifdef _WIN32
+    // Sem mmap: o arquivo é lido inteiro para a memória
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Erro ao abrir o snapshot: " << filename << endl;
+        return nullptr;
+    }
+    vector<char> contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    return decodeSnapshot(contents.data(), contents.size(), filename);
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Erro ao abrir o snapshot: " << filename << endl;
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(HEADER_SIZE)) {
+        close(fd);
+        cerr << "Snapshot vazio ou ilegível: " << filename << endl;
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        cerr << "Erro ao mapear o snapshot: " << filename << endl;
+        return nullptr;
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    DataFrame* df = decodeSnapshot(static_cast<const char*>(mapped), size, filename);
+    munmap(mapped, size);
+    return df;
+#endif
+}
@@ -113,6 +113,7 @@ void extractFromDB(sqlite3 *db,
 void processDBBlocks(const vector<vector<string>>& linesRead, DataFrame* df, int& recordsCount, bool& DBAlreadyRead, mutex& mtxDB, mutex& mtxCounter) {
     /*
     Esse método processa os blocos lidos do DB e preenche o DataFrame.
+    Cada bloco é publicado com a sua linha inicial, então o DataFrame mantém a ordem da consulta.
     */
     int blocksize = DBPROCESS_BLOCKSIZE;
     while(!DBAlreadyRead || recordsCount < linesRead.size()){
@@ -135,7 +136,8 @@ void processDBBlocks(const vector<vector<string>>& linesRead, DataFrame* df, int
         vector<vector<string>>::const_iterator last = linesRead.begin() + lastLine;
         vector<vector<string>> blockRead(first, last);
         mtxDB.unlock();
-        df->addMultipleRecords(blockRead);
+        // A linha inicial do bloco no resultado da consulta define a sua posição no DataFrame
+        df->addMultipleRecords(blockRead, firstLine);
     }
 }
 
@@ -208,6 +210,8 @@ DataFrame* readDB(const string& filename, string tableName, int numThreads, vect
         futures[i].wait();
     }
 
+    // Junta os blocos publicados pelas threads de processamento
+    df->consolidate();
     return df;
 }
 
@@ -255,5 +259,7 @@ DataFrame* readDB(int id, const string& filename, string tableName, int numThrea
         futures[i].wait();
     }
 
+    // Junta os blocos publicados pelas threads de processamento
+    df->consolidate();
     return df;
 }
\ No newline at end of file
@@ -14,15 +14,21 @@
 #include <future>
 #include <cmath>
 #include <numeric>
+#include <limits>
+#include <cstring>
 
 #include "../include/df.h"
 #include "../include/threads.h"
 #include "../include/tratadores.h"
+#include "../include/flat_hash_map.h"
+#include "../include/quantile_sketch.h"
+#include "../include/hyperloglog.h"
+#include "../include/datetime.h"
 
 using namespace std;
 
 // Tipo possível das variáveis
-using ElementType = variant<int, float, bool, string>; 
+using ElementType = variant<int, float, bool, string, long long>; 
 
 // Função auxiliar para filtrar um bloco de registros
 vector<int> filter_block_records(DataFrame& df, function<bool(const vector<ElementType>&)> condition, int idxMin, int idxMax) {
@@ -78,82 +84,761 @@ DataFrame filter_records(DataFrame& df, int id, int numThreads, function<bool(co
     return filter_records_by_idxes(df, idxValidos);
 }
 
-DataFrame groupby_mean(DataFrame& df, int id, int numThreads, const string& groupCol, const string& targetCol, ThreadPool& pool) {
-    int groupIdx = df.getColumnIndex(groupCol);
-    int targetIdx = df.getColumnIndex(targetCol);
+// Resultado de um predicado em uma linha, em lógica de três valores: valores de outro tipo
+// (nulos) não são comparáveis e dão UNKNOWN, que NOT mantém. Com esta ordem AND é o mínimo,
+// OR o máximo e NOT é MASK_TRUE - x; só linhas MASK_TRUE são selecionadas.
+const uint8_t MASK_FALSE = 0;
+const uint8_t MASK_UNKNOWN = 1;
+const uint8_t MASK_TRUE = 2;
+
+// Predicado já associado às colunas do DataFrame, com os literais no tipo guardado na coluna
+struct BoundPredicate {
+    enum Storage { INT, BOOL, WIDE, FLOAT, STRING };
+
+    Predicate::Kind kind = Predicate::COMPARE;
+    Predicate::Op op = Predicate::EQ;
+    ColumnRef column{nullptr, nullptr, 0};
+    Storage storage = INT;
+    bool isConstant = false;           // o literal não pode ocorrer na coluna (ex.: x = 2.5 em int)
+    bool constantResult = false;
+    vector<long long> ints;            // literais de colunas INT, BOOL e WIDE (IN_LIST: ordenados)
+    vector<double> floats;             // literais de colunas FLOAT (IN_LIST: ordenados)
+    vector<string> strings;            // literais de colunas STRING
+    FlatHashMap<string, bool> stringSet;
+    vector<BoundPredicate> children;
+};
+
+double literal_units(const Literal& literal, const string& colType) {
+    /*
+    Valor de um literal nas unidades guardadas na coluna: textos são lidos no tipo da
+    coluna (datas, horários, decimais) e números em colunas decimal viram centavos.
+    */
+    if (const string* text = get_if<string>(&literal.value)) {
+        ElementType value = parseValue(*text, colType);
+        double units = 0.0;
+        if (const bool* b = get_if<bool>(&value)) units = *b ? 1.0 : 0.0;
+        else numericValue(value, 1.0, units);
+        return units;
+    }
+
+    double units = 0.0;
+    if (const long long* i = get_if<long long>(&literal.value)) units = static_cast<double>(*i);
+    else if (const double* d = get_if<double>(&literal.value)) units = *d;
+    else if (const bool* b = get_if<bool>(&literal.value)) units = *b ? 1.0 : 0.0;
+
+    if (colType == "decimal") {
+        // 500.01 * 100 não é exatamente 50001 em double
+        units *= DECIMAL_SCALE;
+        if (fabs(units - round(units)) < 1e-6) units = round(units);
+    }
+    return units;
+}
+
+string literal_text(const Literal& literal) {
+    return visit([](const auto& arg) -> string {
+        using T = decay_t<decltype(arg)>;
+        if constexpr (is_same_v<T, string>) return arg;
+        else if constexpr (is_same_v<T, bool>) return arg ? "true" : "false";
+        else return to_string(arg);
+    }, literal.value);
+}
+
+BoundPredicate bind_predicate(const DataFrameView& df, const Predicate& predicate) {
+    /*
+    Associa o predicado às colunas do DataFrame e converte os literais uma única vez,
+    antes da avaliação. Lança invalid_argument para colunas inexistentes.
+    */
+    BoundPredicate bound;
+    bound.kind = predicate.kind;
+    bound.op = predicate.op;
+
+    if (predicate.kind == Predicate::AND || predicate.kind == Predicate::OR || predicate.kind == Predicate::NOT) {
+        size_t expected = predicate.kind == Predicate::NOT ? 1 : 2;
+        if (predicate.children.size() != expected) {
+            throw invalid_argument("Predicado AND/OR/NOT com número de filhos inválido.");
+        }
+        for (const Predicate& child : predicate.children) bound.children.push_back(bind_predicate(df, child));
+        return bound;
+    }
+
+    int colIdx = df.getColumnIndex(predicate.column);
+    size_t expectedValues = predicate.kind == Predicate::COMPARE ? 1 : predicate.kind == Predicate::BETWEEN ? 2 : 0;
+    if (expectedValues > 0 && predicate.values.size() != expectedValues) {
+        throw invalid_argument("Número de literais inválido no predicado da coluna '" + predicate.column + "'.");
+    }
+
+    string colType = df.getColumnType(colIdx);
+    bound.column = df.getColumn(colIdx);
+
+    if (colType == "string") {
+        bound.storage = BoundPredicate::STRING;
+        for (const Literal& literal : predicate.values) bound.strings.push_back(literal_text(literal));
+        if (predicate.kind == Predicate::IN_LIST) {
+            for (const string& literal : bound.strings) bound.stringSet[literal] = true;
+        }
+        return bound;
+    }
+
+    if (colType == "float") {
+        bound.storage = BoundPredicate::FLOAT;
+        // Literais arredondados para float, para que "x = 0.1" encontre o valor lido como float
+        for (const Literal& literal : predicate.values) bound.floats.push_back(static_cast<float>(literal_units(literal, colType)));
+        if (predicate.kind == Predicate::IN_LIST) sort(bound.floats.begin(), bound.floats.end());
+        return bound;
+    }
+
+    // Colunas inteiras: literais fracionários são ajustados para comparações entre inteiros
+    bound.storage = colType == "bool" ? BoundPredicate::BOOL
+                  : (colType == "int" || colType == "date") ? BoundPredicate::INT
+                  : BoundPredicate::WIDE;
+    vector<double> units;
+    for (const Literal& literal : predicate.values) units.push_back(literal_units(literal, colType));
+
+    if (predicate.kind == Predicate::COMPARE) {
+        double x = units[0];
+        bool integral = floor(x) == x;
+        switch (predicate.op) {
+            case Predicate::EQ:
+            case Predicate::NE:
+                bound.isConstant = !integral;
+                bound.constantResult = predicate.op == Predicate::NE;
+                bound.ints.push_back(static_cast<long long>(x));
+                break;
+            case Predicate::GT:
+            case Predicate::LE:
+                bound.ints.push_back(static_cast<long long>(floor(x)));
+                break;
+            case Predicate::GE:
+            case Predicate::LT:
+                bound.ints.push_back(static_cast<long long>(ceil(x)));
+                break;
+        }
+    } else if (predicate.kind == Predicate::BETWEEN) {
+        bound.ints.push_back(static_cast<long long>(ceil(units[0])));
+        bound.ints.push_back(static_cast<long long>(floor(units[1])));
+    } else {
+        for (double x : units) {
+            if (floor(x) == x) bound.ints.push_back(static_cast<long long>(x));
+        }
+        sort(bound.ints.begin(), bound.ints.end());
+    }
+    return bound;
+}
+
+template <typename Stored, typename Literal, typename Values>
+void compare_chunk(const Values& values, size_t len, Predicate::Op op, const Literal& literal, uint8_t* mask) {
+    /*
+    Compara um trecho da coluna com um literal, gravando MASK_TRUE/MASK_FALSE em mask.
+    O operador é resolvido fora do laço, que fica só com a leitura do valor e a comparação.
+    Valores de outro tipo (nulos) dão MASK_UNKNOWN.
+    */
+    auto run = [&](auto test) {
+        for (size_t i = 0; i < len; ++i) {
+            const Stored* v = get_if<Stored>(&values[i]);
+            mask[i] = v == nullptr ? MASK_UNKNOWN : test(*v) ? MASK_TRUE : MASK_FALSE;
+        }
+    };
+    switch (op) {
+        case Predicate::EQ: run([&literal](const Stored& v) { return v == literal; }); break;
+        case Predicate::NE: run([&literal](const Stored& v) { return v != literal; }); break;
+        case Predicate::LT: run([&literal](const Stored& v) { return v < literal; }); break;
+        case Predicate::LE: run([&literal](const Stored& v) { return v <= literal; }); break;
+        case Predicate::GT: run([&literal](const Stored& v) { return v > literal; }); break;
+        case Predicate::GE: run([&literal](const Stored& v) { return v >= literal; }); break;
+    }
+}
+
+template <typename Stored, typename Literal, typename Values>
+void leaf_chunk(const BoundPredicate& node, const Values& values, size_t len, const vector<Literal>& literals, uint8_t* mask) {
+    // Avalia uma folha (comparação, faixa ou IN) para colunas cujo valor é Stored
+    if (node.isConstant) {
+        uint8_t result = node.constantResult ? MASK_TRUE : MASK_FALSE;
+        for (size_t i = 0; i < len; ++i) mask[i] = holds_alternative<Stored>(values[i]) ? result : MASK_UNKNOWN;
+    } else if (node.kind == Predicate::COMPARE) {
+        compare_chunk<Stored>(values, len, node.op, literals[0], mask);
+    } else if (node.kind == Predicate::BETWEEN) {
+        const Literal& low = literals[0];
+        const Literal& high = literals[1];
+        for (size_t i = 0; i < len; ++i) {
+            const Stored* v = get_if<Stored>(&values[i]);
+            mask[i] = v == nullptr ? MASK_UNKNOWN : (low <= *v && *v <= high) ? MASK_TRUE : MASK_FALSE;
+        }
+    } else {
+        for (size_t i = 0; i < len; ++i) {
+            const Stored* v = get_if<Stored>(&values[i]);
+            mask[i] = v == nullptr ? MASK_UNKNOWN
+                    : binary_search(literals.begin(), literals.end(), static_cast<Literal>(*v)) ? MASK_TRUE : MASK_FALSE;
+        }
+    }
+}
+
+template <typename Values>
+void evaluate_leaf(const BoundPredicate& node, const Values& values, size_t len, uint8_t* mask) {
+    // Avalia uma folha no tipo guardado na coluna
+    switch (node.storage) {
+        case BoundPredicate::INT:
+            leaf_chunk<int>(node, values, len, node.ints, mask);
+            break;
+        case BoundPredicate::BOOL:
+            leaf_chunk<bool>(node, values, len, node.ints, mask);
+            break;
+        case BoundPredicate::WIDE:
+            leaf_chunk<long long>(node, values, len, node.ints, mask);
+            break;
+        case BoundPredicate::FLOAT:
+            leaf_chunk<float>(node, values, len, node.floats, mask);
+            break;
+        case BoundPredicate::STRING:
+            if (node.kind == Predicate::IN_LIST) {
+                for (size_t i = 0; i < len; ++i) {
+                    const string* v = get_if<string>(&values[i]);
+                    mask[i] = v == nullptr ? MASK_UNKNOWN : node.stringSet.find(*v) != nullptr ? MASK_TRUE : MASK_FALSE;
+                }
+            } else {
+                leaf_chunk<string>(node, values, len, node.strings, mask);
+            }
+            break;
+    }
+}
+
+void evaluate_chunk(const BoundPredicate& node, size_t start, size_t len, uint8_t* mask) {
+    /*
+    Avalia o predicado nas linhas [start, start + len) e grava MASK_TRUE, MASK_FALSE ou
+    MASK_UNKNOWN em mask. AND e OR combinam as máscaras dos filhos byte a byte (mínimo e
+    máximo) e pulam o segundo filho quando o primeiro já decide todas as linhas do trecho.
+    */
+    if (node.kind == Predicate::AND || node.kind == Predicate::OR) {
+        evaluate_chunk(node.children[0], start, len, mask);
+        bool isAnd = node.kind == Predicate::AND;
+        uint8_t decisive = isAnd ? MASK_FALSE : MASK_TRUE;
+        bool decided = true;
+        for (size_t i = 0; i < len && decided; ++i) decided = (mask[i] == decisive);
+        if (decided) return;
+
+        vector<uint8_t> other(len);
+        evaluate_chunk(node.children[1], start, len, other.data());
+        if (isAnd) for (size_t i = 0; i < len; ++i) mask[i] = min(mask[i], other[i]);
+        else for (size_t i = 0; i < len; ++i) mask[i] = max(mask[i], other[i]);
+        return;
+    }
+    if (node.kind == Predicate::NOT) {
+        evaluate_chunk(node.children[0], start, len, mask);
+        for (size_t i = 0; i < len; ++i) mask[i] = MASK_TRUE - mask[i];
+        return;
+    }
+
+    // Sem seleção os valores do trecho são contíguos; com seleção são lidos pelos índices da view
+    ColumnRef values = node.column.slice(start, len);
+    if (values.contiguous()) evaluate_leaf(node, values.data(), len, mask);
+    else evaluate_leaf(node, values, len, mask);
+}
+
+vector<size_t> select_rows(const DataFrameView& df, int id, int numThreads, const Predicate& predicate, ThreadPool& pool) {
+    /*
+    Índices (em ordem crescente) das linhas que satisfazem o predicado. Cada thread avalia
+    o seu bloco em trechos de tamanho fixo, coluna a coluna, gerando máscaras de bytes.
+    Em uma view com seleção os índices são posições na view.
+    */
+    const size_t CHUNK_SIZE = 4096;
+    BoundPredicate bound = bind_predicate(df, predicate);
+
+    size_t dataSize = df.getNumRecords();
+    if (dataSize == 0) return {};
+    numThreads = max(1, min(numThreads, static_cast<int>(dataSize)));
+    size_t blockSize = (dataSize + numThreads - 1) / numThreads;
+
+    vector<vector<size_t>> partialRows(numThreads);
+    vector<future<void>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, dataSize);
+        size_t end = min(start + blockSize, dataSize);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            vector<uint8_t> mask(CHUNK_SIZE);
+            vector<size_t> rows;
+            for (size_t chunk = start; chunk < end; chunk += CHUNK_SIZE) {
+                size_t len = min(CHUNK_SIZE, end - chunk);
+                evaluate_chunk(bound, chunk, len, mask.data());
+                for (size_t i = 0; i < len; ++i) {
+                    if (mask[i] == MASK_TRUE) rows.push_back(chunk + i);
+                }
+            }
+            partialRows[t] = move(rows);
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    vector<size_t> rows;
+    size_t total = 0;
+    for (const auto& partial : partialRows) total += partial.size();
+    rows.reserve(total);
+    for (auto& partial : partialRows) rows.insert(rows.end(), partial.begin(), partial.end());
+    return rows;
+}
+
+DataFrame filter_where(const DataFrameView& df, int id, int numThreads, const Predicate& predicate, ThreadPool& pool) {
+    /*
+    Filtra o DataFrame por um predicado colunar (ver predicate.h), sem montar as linhas
+    como vetores de ElementType: select_rows encontra as linhas e gather_rows as copia
+    coluna a coluna, em paralelo.
+    */
+    vector<size_t> rows = select_rows(df, id, numThreads, predicate, pool);
+    return gather_rows(df, rows, id, numThreads, pool);
+}
+
+DataFrameView filter_view(const DataFrameView& df, int id, int numThreads, const Predicate& predicate, ThreadPool& pool) {
+    /*
+    Como filter_where, mas sem copiar dados: retorna uma view do mesmo DataFrame base
+    com a seleção das linhas que satisfazem o predicado. Filtros encadeados refinam a seleção.
+    */
+    return df.take(select_rows(df, id, numThreads, predicate, pool));
+}
+
+size_t estimate_distinct(ColumnRef column, size_t start, size_t end) {
+    /*
+    Estima o número de valores distintos em column[start, end) a partir de uma amostra
+    espaçada (estimador GEE: sqrt(n/s) * f1 + demais distintos, f1 = vistos uma única vez).
+    Usado para pré-dimensionar as tabelas hash e evitar redimensionamentos.
+    */
+    const size_t SAMPLE_SIZE = 1024;
+    if (end <= start) return 0;
+    size_t n = end - start;
+    if (n <= SAMPLE_SIZE) return n;
+
+    FlatHashMap<ElementType, int> sample(SAMPLE_SIZE);
+    size_t step = n / SAMPLE_SIZE;
+    for (size_t i = 0; i < SAMPLE_SIZE; ++i) {
+        sample[column[start + i * step]]++;
+    }
+
+    size_t singletons = 0;
+    for (const auto& [key, count] : sample) {
+        if (count == 1) singletons++;
+    }
+    double estimate = sqrt(static_cast<double>(n) / SAMPLE_SIZE) * singletons + (sample.size() - singletons);
+    return min(n, static_cast<size_t>(estimate));
+}
+
+// Limites para o caminho de agregação com vetores densos
+const size_t DENSE_MAX_SLOTS = 1 << 24;   // Máximo de posições somando os vetores de todas as threads
+const size_t DENSE_MIN_KEYS_PER_SLOT = 2; // A faixa de chaves não pode ser maior que numRecords * 2
+
+DenseKeyRange dense_key_range(ColumnRef column, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Calcula, em paralelo, o mínimo e o máximo de uma coluna de inteiros e decide
+    se as chaves podem ser indexadas diretamente em um vetor (faixa pequena e densa).
+    */
+    DenseKeyRange range;
+    size_t dataSize = column.size();
+    if (dataSize == 0 || numThreads < 1) return range;
+
+    numThreads = min(numThreads, static_cast<int>(dataSize));
+    size_t blockSize = (dataSize + numThreads - 1) / numThreads;
+
+    // Cada thread devolve (válido, mínimo, máximo) do seu bloco
+    vector<future<tuple<bool, int, int>>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = t * blockSize;
+        size_t end = min(start + blockSize, dataSize);
+        if (start >= end) break;
+
+        futures.push_back(pool.enqueue(-id, [&column, start, end]() {
+            int localMin = numeric_limits<int>::max();
+            int localMax = numeric_limits<int>::min();
+            for (size_t i = start; i < end; ++i) {
+                const int* value = get_if<int>(&column[i]);
+                if (!value) return make_tuple(false, 0, 0);
+                localMin = min(localMin, *value);
+                localMax = max(localMax, *value);
+            }
+            return make_tuple(true, localMin, localMax);
+        }));
+    }
+
+    pool.isReady(-id);
+
+    int globalMin = numeric_limits<int>::max();
+    int globalMax = numeric_limits<int>::min();
+    bool allInts = true;
+    for (auto& f : futures) {
+        auto [valid, localMin, localMax] = f.get();
+        allInts = allInts && valid;
+        globalMin = min(globalMin, localMin);
+        globalMax = max(globalMax, localMax);
+    }
+    if (!allInts) return range;
+
+    size_t numKeys = static_cast<size_t>(static_cast<long long>(globalMax) - globalMin) + 1;
+    if (numKeys * numThreads > DENSE_MAX_SLOTS || numKeys > dataSize * DENSE_MIN_KEYS_PER_SLOT) return range;
+
+    range.dense = true;
+    range.minKey = globalMin;
+    range.maxKey = globalMax;
+    return range;
+}
+
+template <typename T>
+vector<T> merge_dense_arrays(vector<vector<T>>& partials, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Soma posição a posição os vetores parciais das threads. Cada tarefa cuida de uma
+    faixa de chaves, então o laço interno é uma soma de vetores contíguos (vetorizável).
+    */
+    vector<T> merged = move(partials[0]);
+    size_t numKeys = merged.size();
+    if (partials.size() == 1 || numKeys == 0) return merged;
+
+    numThreads = max(1, min(numThreads, static_cast<int>(numKeys)));
+    size_t blockSize = (numKeys + numThreads - 1) / numThreads;
+
+    vector<future<void>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = t * blockSize;
+        size_t end = min(start + blockSize, numKeys);
+        if (start >= end) break;
+
+        futures.push_back(pool.enqueue(-id, [&merged, &partials, start, end]() {
+            T* dst = merged.data();
+            for (size_t p = 1; p < partials.size(); ++p) {
+                const T* src = partials[p].data();
+                for (size_t k = start; k < end; ++k) {
+                    dst[k] += src[k];
+                }
+            }
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    return merged;
+}
+
+int merge_partition_count(int numThreads) {
+    /*
+    Número de partições (potência de dois) em que os resultados parciais são divididos
+    para que a fusão seja feita em paralelo. Usamos o dobro de threads para balancear.
+    */
+    int numPartitions = 1;
+    while (numPartitions < 2 * numThreads && numPartitions < 256) numPartitions <<= 1;
+    return numPartitions;
+}
+
+inline size_t partition_of(const ElementType& key, int numPartitions) {
+    // Usa os bits altos do hash, já que a FlatHashMap posiciona as chaves pelos bits baixos
+    return (mix_hash(hash<ElementType>{}(key)) >> 56) & (numPartitions - 1);
+}
+
+template <typename V, typename Combine>
+vector<FlatHashMap<ElementType, V>> merge_partitioned_maps(vector<vector<FlatHashMap<ElementType, V>>>& partials, int numPartitions, int id, ThreadPool& pool, Combine combine) {
+    /*
+    Funde os mapas parciais das threads. Como cada chave pertence a uma única partição,
+    cada tarefa do pool funde uma partição de forma independente das demais.
+    */
+    vector<FlatHashMap<ElementType, V>> merged(numPartitions);
+    vector<future<void>> futures;
+
+    for (int p = 0; p < numPartitions; ++p) {
+        futures.push_back(pool.enqueue(-id, [&, p]() {
+            // O maior mapa parcial serve de base, os outros são fundidos nele
+            size_t base = 0;
+            for (size_t w = 1; w < partials.size(); ++w) {
+                if (partials[w][p].size() > partials[base][p].size()) base = w;
+            }
+            FlatHashMap<ElementType, V> dst = move(partials[base][p]);
+            for (size_t w = 0; w < partials.size(); ++w) {
+                if (w == base) continue;
+                for (const auto& [key, val] : partials[w][p]) {
+                    combine(dst[key], val);
+                }
+                partials[w][p].clear();
+            }
+            merged[p] = move(dst);
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    return merged;
+}
+
+template <typename V, typename Emit>
+void fill_from_partitions(const vector<FlatHashMap<ElementType, V>>& partitions, DataFrameBuilder& result, int id, ThreadPool& pool, Emit emit) {
+    /*
+    Monta o resultado coluna a coluna: as colunas do builder são pré-dimensionadas e
+    cada partição escreve suas linhas, em paralelo, a partir do seu deslocamento.
+    emit(chave, valor, linha) escreve os valores de uma linha com result.column(j).set.
+    */
+    vector<size_t> offsets(partitions.size() + 1, 0);
+    for (size_t p = 0; p < partitions.size(); ++p) {
+        offsets[p + 1] = offsets[p] + partitions[p].size();
+    }
+
+    result.resize(offsets.back());
 
-    const auto& groupVec = df.columns[groupIdx];
-    const auto& targetVec = df.columns[targetIdx];
+    vector<future<void>> futures;
+    for (size_t p = 0; p < partitions.size(); ++p) {
+        if (partitions[p].empty()) continue;
+        futures.push_back(pool.enqueue(-id, [&, p]() {
+            size_t row = offsets[p];
+            for (const auto& [key, val] : partitions[p]) {
+                emit(key, val, row++);
+            }
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+}
+
+template <typename SumT, typename ReadValue>
+DataFrame groupby_mean_dense(const DataFrameView& df, int id, int numThreads, const string& groupCol, const string& targetCol, const DenseKeyRange& range, ThreadPool& pool, ReadValue readValue, double divisor) {
+    /*
+    Versão do groupby_mean para chaves inteiras densas: cada thread acumula somas e
+    contagens em vetores indexados por (chave - mínimo), sem tabelas hash.
+    */
+    const auto& groupVec = df.getColumn(df.getColumnIndex(groupCol));
+    const auto& targetVec = df.getColumn(df.getColumnIndex(targetCol));
 
     int total_records = df.getNumRecords();
-    numThreads = min(numThreads, static_cast<int>(total_records));
+    numThreads = min(numThreads, total_records);
     int block_size = (total_records + numThreads - 1) / numThreads;
+    size_t numKeys = range.size();
+    int minKey = range.minKey;
 
-    vector<shared_ptr<promise<unordered_map<string, pair<float, int>>>>> promises(numThreads);
-    vector<future<unordered_map<string, pair<float, int>>>> futures;
+    vector<vector<SumT>> partialSums(numThreads);
+    vector<vector<int>> partialCounts(numThreads);
+    vector<future<void>> futures;
 
-    // Define o relacionamento entre promessas e futuros
-    for (int i = 0; i < numThreads; ++i) {
-        promises[i] = make_shared<promise<unordered_map<string, pair<float, int>>>>();
-        futures.push_back(promises[i]->get_future());
+    for (int t = 0; t < numThreads; ++t) {
+        int start = t * block_size;
+        int end = min(start + block_size, total_records);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            vector<SumT> sums(numKeys, SumT(0));
+            vector<int> counts(numKeys, 0);
+            for (int i = start; i < end; ++i) {
+                size_t slot = get<int>(groupVec[i]) - minKey;
+                if (!readValue(targetVec[i], sums[slot])) continue;
+                counts[slot]++;
+            }
+            partialSums[t] = move(sums);
+            partialCounts[t] = move(counts);
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    // Fusão dos resultados
+    vector<SumT> sums = merge_dense_arrays(partialSums, id, numThreads, pool);
+    vector<int> counts = merge_dense_arrays(partialCounts, id, numThreads, pool);
+
+    // Novo DataFrame, preenchido diretamente pelas colunas
+    vector<string> colNames = {groupCol, "mean_" + targetCol};
+    vector<string> colTypes = {"int", "float"};
+    DataFrameBuilder resultDf(colNames, colTypes);
+
+    for (size_t k = 0; k < numKeys; ++k) {
+        if (counts[k] == 0) continue;
+        resultDf.column(0).push_back(static_cast<int>(k + minKey));
+        resultDf.column(1).push_back(static_cast<float>(sums[k] / divisor / counts[k]));
+    }
+
+    return resultDf.finish();
+}
+
+DataFrame count_values_dense(const DataFrameView& df, int id, int numThreads, const string& colName, int numDays, const DenseKeyRange& range, ThreadPool& pool) {
+    /*
+    Versão do count_values para chaves inteiras densas: contagens por thread em vetores
+    indexados por (chave - mínimo), somados ao final.
+    */
+    ColumnRef column = df.getColumn(df.getColumnIndex(colName));
+    size_t dataSize = column.size();
+    numThreads = min(numThreads, static_cast<int>(dataSize));
+    size_t blockSize = (dataSize + numThreads - 1) / numThreads;
+    size_t numKeys = range.size();
+    int minKey = range.minKey;
+
+    vector<vector<int>> partialCounts(numThreads, vector<int>());
+    vector<future<void>> futures;
+
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = t * blockSize;
+        size_t end = min(start + blockSize, dataSize);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            vector<int> counts(numKeys, 0);
+            for (size_t i = start; i < end; ++i) {
+                counts[get<int>(column[i]) - minKey]++;
+            }
+            partialCounts[t] = move(counts);
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    vector<int> counts = merge_dense_arrays(partialCounts, id, numThreads, pool);
+
+    vector<string> colNames = {colName, "count"};
+    vector<string> colTypes = {"int", "int"};
+    DataFrameBuilder result(colNames, colTypes);
+
+    for (size_t k = 0; k < numKeys; ++k) {
+        if (counts[k] == 0) continue;
+        int finalCount = (numDays > 0) ? counts[k] / numDays : counts[k];
+        result.column(0).push_back(static_cast<int>(k + minKey));
+        result.column(1).push_back(finalCount);
+    }
+
+    return result.finish();
+}
+
+template <typename SumT, typename ReadValue>
+DataFrame groupby_mean_typed(const DataFrameView& df, int id, int numThreads, const string& groupCol, const string& targetCol, ThreadPool& pool, ReadValue readValue, double divisor) {
+    /*
+    groupby_mean com somas do tipo SumT. readValue(valor, soma) soma o valor ao acumulador
+    e retorna false se o valor não for do tipo esperado (a linha é ignorada).
+    A média de cada grupo é soma / divisor / contagem; grupos sem nenhum valor do tipo
+    esperado ficam fora do resultado, tanto aqui quanto em groupby_mean_dense.
+    */
+    int groupIdx = df.getColumnIndex(groupCol);
+    int targetIdx = df.getColumnIndex(targetCol);
+
+    int total_records = df.getNumRecords();
+    if (total_records == 0) {
+        return DataFrameBuilder({groupCol, "mean_" + targetCol}, {df.getColumnType(groupIdx), "float"}).finish();
+    }
+
+    // Chaves inteiras em faixa pequena: agregação direta em vetores
+    if (df.getColumnType(groupIdx) == "int") {
+        DenseKeyRange range = dense_key_range(df.getColumn(groupIdx), id, numThreads, pool);
+        if (range.dense) {
+            return groupby_mean_dense<SumT>(df, id, numThreads, groupCol, targetCol, range, pool, readValue, divisor);
+        }
     }
 
+    const auto& groupVec = df.getColumn(groupIdx);
+    const auto& targetVec = df.getColumn(targetIdx);
+
+    numThreads = min(numThreads, static_cast<int>(total_records));
+    int block_size = (total_records + numThreads - 1) / numThreads;
+
+    // Cada thread separa suas chaves em partições pelo hash
+    using GroupMap = FlatHashMap<ElementType, pair<SumT, int>>;
+    int numPartitions = merge_partition_count(numThreads);
+    vector<vector<GroupMap>> partials(numThreads);
+    vector<future<void>> futures;
+
     for (int t = 0; t < numThreads; ++t) {
         int start = t * block_size;
         int end = min(start + block_size, total_records);
 
-        pool.enqueue(-id, [&, start, end, p = promises[t]]() mutable {
-            unordered_map<string, pair<float, int>> local_map;
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            size_t expected = estimate_distinct(groupVec, start, end) / numPartitions;
+            vector<GroupMap> local_maps(numPartitions);
+            for (auto& local_map : local_maps) local_map.reserve(expected);
+
             for (int i = start; i < end; ++i) {
-                string key = variantToString(groupVec[i]);
-                float value = get<float>(targetVec[i]);
-                auto& acc = local_map[key];
+                // O grupo só entra no mapa com um valor válido (como as contagens do denso)
+                SumT value(0);
+                if (!readValue(targetVec[i], value)) continue;
+                auto& acc = local_maps[partition_of(groupVec[i], numPartitions)][groupVec[i]];
                 acc.first += value;
                 acc.second += 1;
             }
-            p->set_value(move(local_map));
-        });
+            partials[t] = move(local_maps);
+        }));
     }
 
     pool.isReady(-id);
+    for (auto& f : futures) f.get();
 
-    // Fusão dos resultados
-    unordered_map<string, pair<float, int>> globalMap;
-    for (auto& f : futures) {
-        auto local = f.get();
-        for (const auto& [key, val] : local) {
-            globalMap[key].first += val.first;
-            globalMap[key].second += val.second;
-        }
-    }
+    // Fusão dos resultados, uma partição por tarefa
+    vector<GroupMap> merged = merge_partitioned_maps(partials, numPartitions, id, pool,
+        [](pair<SumT, int>& acc, const pair<SumT, int>& val) {
+            acc.first += val.first;
+            acc.second += val.second;
+        });
 
-    // Novo DataFrame
+    // Novo DataFrame, preenchido diretamente pelas colunas
     vector<string> colNames = {groupCol, "mean_" + targetCol};
     vector<string> colTypes = {df.getColumnType(df.getColumnIndex(groupCol)), "float"};
-    DataFrame resultDf(colNames, colTypes);
+    DataFrameBuilder resultDf(colNames, colTypes);
 
-    for (const auto& [key, pair] : globalMap) {
-        float mean = pair.first / pair.second;
-        resultDf.addRecord({key, to_string(mean)});
-    }
+    fill_from_partitions(merged, resultDf, id, pool,
+        [&resultDf, divisor](const ElementType& key, const pair<SumT, int>& acc, size_t row) {
+            resultDf.column(0).set(row, key);
+            resultDf.column(1).set(row, static_cast<float>(acc.first / divisor / acc.second));
+        });
+
+    return resultDf.finish();
+}
 
-    return resultDf;
+DataFrame groupby_mean(const DataFrameView& df, int id, int numThreads, const string& groupCol, const string& targetCol, ThreadPool& pool) {
+    /*
+    Média de targetCol por grupo de groupCol. Colunas decimal e int são somadas em
+    inteiros de 64 bits, então o resultado é exato e não depende de como as linhas
+    foram divididas entre as threads; colunas float mantêm a soma em float.
+    */
+    string targetType = df.getColumnType(df.getColumnIndex(targetCol));
+
+    if (targetType == "decimal") {
+        return groupby_mean_typed<long long>(df, id, numThreads, groupCol, targetCol, pool,
+            [](const ElementType& value, long long& sum) {
+                const long long* cents = get_if<long long>(&value);
+                if (cents) sum += *cents;
+                return cents != nullptr;
+            }, static_cast<double>(DECIMAL_SCALE));
+    }
+    if (targetType == "int") {
+        return groupby_mean_typed<long long>(df, id, numThreads, groupCol, targetCol, pool,
+            [](const ElementType& value, long long& sum) {
+                const int* v = get_if<int>(&value);
+                if (v) sum += *v;
+                return v != nullptr;
+            }, 1.0);
+    }
+    if (targetType == "float") {
+        return groupby_mean_typed<float>(df, id, numThreads, groupCol, targetCol, pool,
+            [](const ElementType& value, float& sum) {
+                const float* v = get_if<float>(&value);
+                if (v) sum += *v;
+                return v != nullptr;
+            }, 1.0);
+    }
+    throw invalid_argument("Coluna '" + targetCol + "' não é numérica.");
 }
 
 DataFrame join_by_key(const DataFrame& df1, const DataFrame& df2, int id, int numThreads, const string& keyCol, ThreadPool& pool) {
+    // As colunas são lidas diretamente: registros publicados e não consolidados entram antes
+    df1.consolidate();
+    df2.consolidate();
+
     size_t keyIdx1 = df1.getColumnIndex(keyCol);
     size_t keyIdx2 = df2.getColumnIndex(keyCol);
 
     const auto& keyCol1 = df1.columns[keyIdx1];
     const auto& keyCol2 = df2.columns[keyIdx2];
 
-    // Mapa que associa cada valor da chave em df2 a uma lista de posições onde ele aparece
-    unordered_map<int, vector<size_t>> df2Lookup;
-    for (size_t i = 0; i < keyCol2.size(); ++i) {
+    // Mapa que associa cada valor da chave em df2 à primeira posição onde ele aparece;
+    // as demais posições com a mesma chave ficam encadeadas em nextMatch
+    const size_t NO_MATCH = numeric_limits<size_t>::max();
+    FlatHashMap<int, size_t> df2Lookup(estimate_distinct(keyCol2, 0, keyCol2.size()));
+    vector<size_t> nextMatch(keyCol2.size(), NO_MATCH);
+    for (size_t i = keyCol2.size(); i-- > 0; ) {
         // Verifica se o valor da chave naquela linha é do tipo int
         if (holds_alternative<int>(keyCol2[i])) {
             int key = get<int>(keyCol2[i]);
-            df2Lookup[key].push_back(i);
+            size_t* head = df2Lookup.find(key);
+            if (head) {
+                nextMatch[i] = *head;
+                *head = i;
+            } else {
+                df2Lookup[key] = i;
+            }
         }
     }
 
@@ -172,109 +857,127 @@ DataFrame join_by_key(const DataFrame& df1, const DataFrame& df2, int id, int nu
         }
     }
 
-    DataFrame result(resultColNames, result_col_types);
+    DataFrameBuilder result(resultColNames, result_col_types);
 
     size_t numRecords = df1.getNumRecords();
+    if (numRecords == 0) return result.finish();
     numThreads = min(numThreads, static_cast<int>(numRecords));
     size_t blockSize = (numRecords + numThreads - 1) / numThreads;
 
-    vector<shared_ptr<promise<vector<vector<string>>>>> promises(numThreads);
-    vector<future<vector<vector<string>>>> futures;
-
-    for (int i = 0; i < numThreads; ++i) {
-        promises[i] = make_shared<promise<vector<vector<string>>>>();
-        futures.push_back(promises[i]->get_future());
-    }
+    // Fase de busca: cada thread guarda apenas os pares (linha df1, linha df2) encontrados
+    vector<vector<pair<size_t, size_t>>> matches(numThreads);
+    vector<future<void>> futures;
 
     for (int i = 0; i < numThreads; ++i) {
         size_t start = i * blockSize;
         size_t end = min(start + blockSize, numRecords);
 
-        pool.enqueue(-id, [&, start, end, p = promises[i]]() mutable {
-            vector<vector<string>> local_records;
+        futures.push_back(pool.enqueue(-id, [&, start, end, i]() {
+            vector<pair<size_t, size_t>> local_matches;
             for (size_t idx = start; idx < end && idx < numRecords; ++idx) {
                 if (!holds_alternative<int>(keyCol1[idx])) continue;
 
                 int key = get<int>(keyCol1[idx]);
-                auto it = df2Lookup.find(key);
-                if (it == df2Lookup.end()) continue;
+                const size_t* head = df2Lookup.find(key);
+                if (!head) continue;
 
-                for (size_t match_idx : it->second) {
-                    vector<string> record;
-
-                    // Dados do df1
-                    for (size_t j = 0; j < df1.getNumCols(); ++j) {
-                        record.push_back(variantToString(df1.columns[j][idx]));
-                    }
-
-                    // Dados do df2 (sem a chave)
-                    for (size_t j = 0; j < df2.getNumCols(); ++j) {
-                        if (j == keyIdx2) continue;
-                        record.push_back(variantToString(df2.columns[j][match_idx]));
-                    }
-                    local_records.push_back(record);
+                for (size_t match_idx = *head; match_idx != NO_MATCH; match_idx = nextMatch[match_idx]) {
+                    local_matches.emplace_back(idx, match_idx);
                 }
             }
-            p->set_value(move(local_records));
-        });
+            matches[i] = move(local_matches);
+        }));
     }
 
     pool.isReady(-id);
+    for (auto& f : futures) f.get();
 
-    for (auto& f : futures) {
-        auto local = f.get();
-        for (const auto& record : local) {
-            result.addRecord(record);
-        }
+    // Deslocamento de cada bloco no resultado
+    vector<size_t> offsets(numThreads + 1, 0);
+    for (int i = 0; i < numThreads; ++i) {
+        offsets[i + 1] = offsets[i] + matches[i].size();
     }
+    result.resize(offsets.back());
 
-    return result;
+    // Fase de montagem: cada bloco copia seus pares para as colunas já dimensionadas
+    futures.clear();
+    for (int i = 0; i < numThreads; ++i) {
+        if (matches[i].empty()) continue;
+        futures.push_back(pool.enqueue(-id, [&, i]() {
+            size_t row = offsets[i];
+            for (const auto& [idx1, idx2] : matches[i]) {
+                size_t col = 0;
+
+                // Dados do df1
+                for (size_t j = 0; j < df1.getNumCols(); ++j) {
+                    result.column(col++).set(row, df1.columns[j][idx1]);
+                }
+
+                // Dados do df2 (sem a chave)
+                for (size_t j = 0; j < df2.getNumCols(); ++j) {
+                    if (j == keyIdx2) continue;
+                    result.column(col++).set(row, df2.columns[j][idx2]);
+                }
+                row++;
+            }
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    return result.finish();
 }
 
-DataFrame count_values(const DataFrame& df, int id, int numThreads, const string& colName, int numDays, ThreadPool& pool) {
+DataFrame count_values(const DataFrameView& df, int id, int numThreads, const string& colName, int numDays, ThreadPool& pool) {
     int colIdx = df.getColumnIndex(colName);
-    const vector<ElementType>& column = df.columns[colIdx];
+    ColumnRef column = df.getColumn(colIdx);
+    if (column.size() == 0) {
+        return DataFrameBuilder({colName, "count"}, {df.getColumnType(colIdx), "int"}).finish();
+    }
+
+    // Chaves inteiras em faixa pequena: contagem direta em vetores
+    if (df.getColumnType(colIdx) == "int") {
+        DenseKeyRange range = dense_key_range(column, id, numThreads, pool);
+        if (range.dense) {
+            return count_values_dense(df, id, numThreads, colName, numDays, range, pool);
+        }
+    }
     size_t dataSize = column.size();
     numThreads = min(numThreads, static_cast<int>(dataSize));
     size_t blockSize = (dataSize + numThreads - 1) / numThreads;
 
-    vector<shared_ptr<promise<unordered_map<string, int>>>> promises(numThreads);
-    vector<future<unordered_map<string, int>>> futures;
+    using CountMap = FlatHashMap<ElementType, int>;
+    int numPartitions = merge_partition_count(numThreads);
+    vector<vector<CountMap>> partials(numThreads, vector<CountMap>(numPartitions));
+    vector<future<void>> futures;
 
-    // Cálculo de contagens para cada thread
+    // Cálculo de contagens para cada thread, já separadas em partições pelo hash da chave
     for (int t = 0; t < numThreads; ++t) {
-        // Criando uma promise para um future
-        promises[t] = make_shared<promise<unordered_map<string, int>>>();
-        futures.push_back(promises[t]->get_future());
-
         size_t start = t * blockSize;
         size_t end = min(start + blockSize, dataSize);
 
         if (start >= end) break;
 
         // Enfileira tarefa no threadpool
-        pool.enqueue(-id, [&, start, end, p = promises[t]]() mutable {
-            unordered_map<string, int> localCount;
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            size_t expected = estimate_distinct(column, start, end) / numPartitions;
+            vector<CountMap> localCounts(numPartitions);
+            for (auto& localCount : localCounts) localCount.reserve(expected);
+
             for (size_t i = start; i < end; ++i) {
-                string key = variantToString(column[i]);
-                localCount[key]++;
+                localCounts[partition_of(column[i], numPartitions)][column[i]]++;
             }
-            // Desbloqueia o future e envia o valor a ele
-            p->set_value(move(localCount));
-        });
+            partials[t] = move(localCounts);
+        }));
     }
 
     pool.isReady(-id);
+    for (auto& f : futures) f.get();
 
-    // Junta os resultados
-    unordered_map<string, int> global_count;
-    for (auto& f : futures) {
-        // f.get() é bloqueado até que a thred mande o valor da promise ao future
-        auto local = f.get();
-        for (const auto& [key, count] : local) {
-            global_count[key] += count;
-        }
-    }
+    // Junta os resultados, uma partição por tarefa
+    vector<CountMap> global_count = merge_partitioned_maps(partials, numPartitions, id, pool,
+        [](int& acc, int count) { acc += count; });
 
     // Pegando tipo da coluna original
     int idxColumn = df.getColumnIndex(colName);
@@ -282,23 +985,163 @@ DataFrame count_values(const DataFrame& df, int id, int numThreads, const string
 
     vector<string> colNames = {colName, "count"};
     vector<string> colTypes = {typeColumn, "int"};
-    DataFrame result(colNames, colTypes);
+    DataFrameBuilder result(colNames, colTypes);
 
     // Adicionando registros
-    for (const auto& [key, count] : global_count) {
-        int finalCount = (numDays > 0) ? count / numDays : count;
-        result.addRecord({key, to_string(finalCount)});
+    fill_from_partitions(global_count, result, id, pool,
+        [&result, numDays](const ElementType& key, int count, size_t row) {
+            result.column(0).set(row, key);
+            result.column(1).set(row, (numDays > 0) ? count / numDays : count);
+        });
+
+    return result.finish();
+}
+
+inline uint64_t element_hash(const ElementType& value) {
+    return mix_hash(hash<ElementType>{}(value));
+}
+
+size_t count_distinct(const DataFrameView& df, int id, int numThreads, const string& colName, ThreadPool& pool, bool approximate) {
+    /*
+    Número de valores distintos de uma coluna.
+    Exato: cada thread guarda as chaves do seu bloco em conjuntos separados por partição
+    do hash, e cada partição é fundida em paralelo (como em count_values, sem contagens).
+    Aproximado: cada thread resume o seu bloco em um HyperLogLog de poucos KB e os
+    sketches são fundidos pelo máximo de cada registrador.
+    */
+    const auto& column = df.getColumn(df.getColumnIndex(colName));
+    int total_records = df.getNumRecords();
+    if (total_records == 0) return 0;
+    numThreads = min(numThreads, total_records);
+    int block_size = (total_records + numThreads - 1) / numThreads;
+    vector<future<void>> futures;
+
+    if (approximate) {
+        vector<HyperLogLog> partials(numThreads);
+        for (int t = 0; t < numThreads; ++t) {
+            int start = t * block_size;
+            int end = min(start + block_size, total_records);
+
+            futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+                for (int i = start; i < end; ++i) partials[t].add(element_hash(column[i]));
+            }));
+        }
+        pool.isReady(-id);
+        for (auto& f : futures) f.get();
+
+        for (int t = 1; t < numThreads; ++t) partials[0].merge(partials[t]);
+        return static_cast<size_t>(llround(partials[0].estimate()));
     }
 
-    return result;
+    using KeySet = FlatHashMap<ElementType, bool>;
+    int numPartitions = merge_partition_count(numThreads);
+    vector<vector<KeySet>> partials(numThreads);
+
+    for (int t = 0; t < numThreads; ++t) {
+        int start = t * block_size;
+        int end = min(start + block_size, total_records);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            size_t expected = estimate_distinct(column, start, end) / numPartitions;
+            vector<KeySet> local_sets(numPartitions);
+            for (auto& local_set : local_sets) local_set.reserve(expected);
+
+            for (int i = start; i < end; ++i) {
+                local_sets[partition_of(column[i], numPartitions)][column[i]] = true;
+            }
+            partials[t] = move(local_sets);
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    vector<KeySet> merged = merge_partitioned_maps(partials, numPartitions, id, pool,
+        [](bool&, const bool&) {});
+
+    size_t distinct = 0;
+    for (const auto& keys : merged) distinct += keys.size();
+    return distinct;
+}
+
+DataFrame count_distinct_by(const DataFrameView& df, int id, int numThreads, const string& groupCol, const string& targetCol, ThreadPool& pool, bool approximate) {
+    /*
+    Número de valores distintos de targetCol para cada valor de groupCol
+    (ex.: contas distintas por cidade). Segue o groupby_mean: mapas por thread separados
+    em partições pelo hash do grupo e fundidos uma partição por tarefa.
+    No modo aproximado cada grupo guarda um HyperLogLog em vez do conjunto de valores.
+    */
+    int groupIdx = df.getColumnIndex(groupCol);
+    const auto& groupVec = df.getColumn(groupIdx);
+    const auto& targetVec = df.getColumn(df.getColumnIndex(targetCol));
+
+    vector<string> colNames = {groupCol, "distinct_" + targetCol};
+    vector<string> colTypes = {df.getColumnType(groupIdx), "int"};
+    DataFrameBuilder resultDf(colNames, colTypes);
+
+    int total_records = df.getNumRecords();
+    if (total_records == 0) return resultDf.finish();
+    numThreads = min(numThreads, total_records);
+    int block_size = (total_records + numThreads - 1) / numThreads;
+    int numPartitions = merge_partition_count(numThreads);
+
+    // Agregação por grupo com o acumulador Acc; add registra um valor, combine funde dois acumuladores
+    auto aggregate = [&](auto emptyAcc, auto add, auto combine, auto distinctOf) {
+        using Acc = decltype(emptyAcc);
+        using GroupMap = FlatHashMap<ElementType, Acc>;
+        vector<vector<GroupMap>> partials(numThreads);
+        vector<future<void>> futures;
+
+        for (int t = 0; t < numThreads; ++t) {
+            int start = t * block_size;
+            int end = min(start + block_size, total_records);
+
+            futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+                size_t expected = estimate_distinct(groupVec, start, end) / numPartitions;
+                vector<GroupMap> local_maps(numPartitions);
+                for (auto& local_map : local_maps) local_map.reserve(expected);
+
+                for (int i = start; i < end; ++i) {
+                    add(local_maps[partition_of(groupVec[i], numPartitions)][groupVec[i]], targetVec[i]);
+                }
+                partials[t] = move(local_maps);
+            }));
+        }
+        pool.isReady(-id);
+        for (auto& f : futures) f.get();
+
+        vector<GroupMap> merged = merge_partitioned_maps(partials, numPartitions, id, pool, combine);
+
+        fill_from_partitions(merged, resultDf, id, pool,
+            [&resultDf, &distinctOf](const ElementType& key, const Acc& acc, size_t row) {
+                resultDf.column(0).set(row, key);
+                resultDf.column(1).set(row, static_cast<int>(distinctOf(acc)));
+            });
+    };
+
+    if (approximate) {
+        aggregate(HyperLogLog(),
+            [](HyperLogLog& acc, const ElementType& value) { acc.add(element_hash(value)); },
+            [](HyperLogLog& acc, const HyperLogLog& val) { acc.merge(val); },
+            [](const HyperLogLog& acc) { return llround(acc.estimate()); });
+    } else {
+        using KeySet = FlatHashMap<ElementType, bool>;
+        aggregate(KeySet(),
+            [](KeySet& acc, const ElementType& value) { acc[value] = true; },
+            [](KeySet& acc, const KeySet& val) {
+                for (const auto& entry : val) acc[entry.first] = true;
+            },
+            [](const KeySet& acc) { return acc.size(); });
+    }
+
+    return resultDf.finish();
 }
 
 DataFrame get_hour_by_time(const DataFrame& df, int id, int numThreads, const string& colName, ThreadPool& pool)
 {
     int idxColumn = df.getColumnIndex(colName);
-    vector<ElementType> timeColumn = df.getColumn(idxColumn);
+    const Column timeColumn = df.getColumn(idxColumn);
     size_t dataSize = timeColumn.size();
-    numThreads = min(numThreads, static_cast<int>(dataSize));
+    numThreads = max(1, min(numThreads, static_cast<int>(dataSize)));
     size_t blockSize = (dataSize + numThreads - 1) / numThreads;
     
     vector<shared_ptr<promise<vector<string>>>> promises(numThreads);
@@ -312,19 +1155,25 @@ DataFrame get_hour_by_time(const DataFrame& df, int id, int numThreads, const st
         
         size_t start = min(t * blockSize, dataSize);
         size_t end = min(start + blockSize, dataSize);
-        if (start >= end) break;
         
-        // Enfileira a tarefa
+        // Enfileira a tarefa (blocos vazios também, para que todo future receba um valor)
         pool.enqueue(-id, [&, start, end, p = promises[t]]() mutable {
             vector<string> partialResult;
+            partialResult.reserve(end - start);
 
             for (size_t i = start; i < end; i++)
             {
+                // Colunas time/timestamp guardam microssegundos; colunas string antigas, "HH:MM:SS"
                 const auto& elem = timeColumn[i];
-                if (holds_alternative<string>(elem))
+                if (const long long* micros = get_if<long long>(&elem))
+                {
+                    string hour;
+                    append_digits(hour, hour_of(*micros), 2);
+                    partialResult.push_back(move(hour));
+                }
+                else if (const string* timeStr = get_if<string>(&elem))
                 {
-                    string timeStr = get<string>(elem);
-                    partialResult.push_back(timeStr.substr(0, 2));
+                    partialResult.push_back(timeStr->substr(0, 2));
                 }
                 else
                 {
@@ -339,290 +1188,1390 @@ DataFrame get_hour_by_time(const DataFrame& df, int id, int numThreads, const st
     pool.isReady(-id);
     
     
-    // Junta os resultados
-    vector<string> hoursColumn;
+    string nameColumn = df.getColumnName(idxColumn);
 
+    // Novo DataFrame com a coluna hour ("HH", texto)
+    vector<string> colNames = {nameColumn};
+    vector<string> colTypes = {"string"};
+    DataFrameBuilder dfHours(colNames, colTypes);
+    ColumnBuilder& colHour = dfHours.column(0);
+    colHour.reserve(dataSize);
+
+    // Junta os resultados
     for(int i = 0; i < numThreads; i++)
     {
         vector<string> partial = futures[i].get();
-        hoursColumn.insert(hoursColumn.end(), partial.begin(), partial.end());
+        for (string& hour : partial) colHour.push_back(move(hour));
     }
 
-    string typeColumn = df.getColumnType(idxColumn);
-    string nameColumn = df.getColumnName(idxColumn);
+    return dfHours.finish();
+}
 
-    // Novo DataFrame com a coluna hour
-    vector<string> colNames = {nameColumn};
-    vector<string> colTypes = {typeColumn};
+string time_bucket_label(TimeUnit unit, int64_t bucketStart) {
+    // Rótulo de um balde: "HH" para horas, "HH:MM" para minutos, "YYYY-MM-DD" para dias
+    char buffer[16];
+    switch (unit) {
+        case HOUR:
+            snprintf(buffer, sizeof(buffer), "%02d", static_cast<int>(bucketStart));
+            return buffer;
+        case MINUTE:
+            snprintf(buffer, sizeof(buffer), "%02d:%02d", static_cast<int>(bucketStart / 60), static_cast<int>(bucketStart % 60));
+            return buffer;
+        case DAY:
+            return format_date(bucketStart);
+        case WEEKDAY: {
+            static const char* names[] = {"domingo", "segunda", "terça", "quarta", "quinta", "sexta", "sábado"};
+            return names[bucketStart];
+        }
+    }
+    return "";
+}
+
+DataFrame time_histogram(const DataFrameView& df, int id, int numThreads, const string& colName, TimeUnit unit, int bucketWidth, int numDays, ThreadPool& pool)
+{
+    /*
+    Conta quantos registros caem em cada balde de tempo, a partir de colunas time, date e
+    timestamp, ou lendo os horários (HH:MM:SS.ffffff, para HOUR e MINUTE) ou as datas
+    (YYYY-MM-DD, para DAY e WEEKDAY) diretamente de colunas string.
+    Cada thread acumula em um vetor de contadores indexado pelo balde, sem criar colunas
+    intermediárias nem tabelas hash. bucketWidth agrupa várias unidades em um balde
+    (ex.: 15 minutos). Valores que não podem ser lidos são ignorados.
+    Como em count_values, se numDays > 0 as contagens são divididas por numDays.
+    O resultado tem as colunas colName (rótulo do início do balde) e count, só com baldes não vazios.
+    */
+    int colIdx = df.getColumnIndex(colName);
+    const auto& column = df.getColumn(colIdx);
+    string colType = df.getColumnType(colIdx);
+    bucketWidth = max(1, bucketWidth);
+
+    // Unidades por ciclo para os baldes de tamanho fixo; dias não têm ciclo
+    int64_t unitsPerCycle = (unit == HOUR) ? 24 : (unit == MINUTE) ? 24 * 60 : (unit == WEEKDAY) ? 7 : 0;
+    size_t fixedBuckets = static_cast<size_t>((unitsPerCycle + bucketWidth - 1) / bucketWidth);
+
+    // Unidade de tempo de um valor (hora, minuto do dia, dias desde 1970 ou dia da semana).
+    // Colunas date, time e timestamp já guardam inteiros; colunas string são lidas no lugar
+    auto unitOf = [unit, &colType](const ElementType& value, int64_t& units) {
+        if (const long long* micros = get_if<long long>(&value)) {
+            if (unit == HOUR) units = hour_of(*micros);
+            else if (unit == MINUTE) units = minute_of_day(*micros);
+            else if (colType != "timestamp") return false;
+            else units = (unit == DAY) ? day_of(*micros) : weekday_from_days(day_of(*micros));
+            return true;
+        }
+        if (const int* days = get_if<int>(&value)) {
+            if (colType != "date" || unit == HOUR || unit == MINUTE) return false;
+            units = (unit == DAY) ? *days : weekday_from_days(*days);
+            return true;
+        }
+
+        const string* text = get_if<string>(&value);
+        if (!text) return false;
+        if (unit == HOUR || unit == MINUTE) {
+            int hour, minute, second;
+            if (!parse_time_of_day(*text, hour, minute, second)) return false;
+            units = (unit == HOUR) ? hour : hour * 60 + minute;
+            return true;
+        }
+        // Strings de data ou de data e hora: vale a data do início
+        if (!parse_date_prefix(*text, units)) return false;
+        if (text->size() > 10 && (*text)[10] != ' ' && (*text)[10] != 'T') return false;
+        if (unit == WEEKDAY) units = weekday_from_days(units);
+        return true;
+    };
+
+    size_t dataSize = column.size();
+    numThreads = max(1, min(numThreads, static_cast<int>(dataSize)));
+    size_t blockSize = (dataSize + numThreads - 1) / numThreads;
+
+    // Para DAY, cada vetor começa no balde partialBase[t] e cresce conforme novas datas aparecem
+    vector<vector<int>> partials(numThreads);
+    vector<int64_t> partialBase(numThreads, 0);
+    vector<future<void>> futures;
+
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, dataSize);
+        size_t end = min(start + blockSize, dataSize);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            vector<int> counts(fixedBuckets, 0);
+            int64_t base = 0;
+            for (size_t i = start; i < end; ++i) {
+                int64_t units;
+                if (!unitOf(column[i], units)) continue;
+                int64_t bucket = (units >= 0 ? units : units - bucketWidth + 1) / bucketWidth;
+
+                if (unit == DAY) {
+                    if (counts.empty()) base = bucket;
+                    if (bucket < base) {
+                        counts.insert(counts.begin(), static_cast<size_t>(base - bucket), 0);
+                        base = bucket;
+                    }
+                    if (static_cast<size_t>(bucket - base) >= counts.size()) counts.resize(bucket - base + 1, 0);
+                }
+                counts[bucket - base]++;
+            }
+            partials[t] = move(counts);
+            partialBase[t] = base;
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    // Baldes de dias: alinha os vetores parciais a partir do menor balde visto
+    int64_t firstBucket = 0;
+    if (unit == DAY) {
+        int64_t lastBucket = 0;
+        bool any = false;
+        for (int t = 0; t < numThreads; ++t) {
+            if (partials[t].empty()) continue;
+            int64_t partialEnd = partialBase[t] + static_cast<int64_t>(partials[t].size());
+            firstBucket = any ? min(firstBucket, partialBase[t]) : partialBase[t];
+            lastBucket = any ? max(lastBucket, partialEnd) : partialEnd;
+            any = true;
+        }
+        for (int t = 0; t < numThreads; ++t) {
+            vector<int> aligned(static_cast<size_t>(lastBucket - firstBucket), 0);
+            if (!partials[t].empty()) copy(partials[t].begin(), partials[t].end(), aligned.begin() + (partialBase[t] - firstBucket));
+            partials[t] = move(aligned);
+        }
+    }
+
+    vector<int> counts = merge_dense_arrays(partials, id, numThreads, pool);
+
+    vector<string> colNames = {colName, "count"};
+    vector<string> colTypes = {"string", "int"};
+    DataFrameBuilder result(colNames, colTypes);
+
+    for (size_t b = 0; b < counts.size(); ++b) {
+        if (counts[b] == 0) continue;
+        int64_t bucketStart = (firstBucket + static_cast<int64_t>(b)) * bucketWidth;
+        result.column(0).push_back(time_bucket_label(unit, bucketStart));
+        result.column(1).push_back((numDays > 0) ? counts[b] / numDays : counts[b]);
+    }
+
+    return result.finish();
+}
+
+DataFrame num_transac_by_hour(const DataFrameView& df, int id, int numThreads, const string& hourCol, int numDays, ThreadPool& pool)
+{
+    // Histograma por hora lido direto dos horários, sem a coluna intermediária de get_hour_by_time
+    return time_histogram(df, id, numThreads, hourCol, HOUR, 1, numDays, pool);
+}
+
+DataFrame extract_datetime_part(const DataFrameView& df, int id, int numThreads, const string& colName, TimeUnit part, ThreadPool& pool)
+{
+    /*
+    Extrai uma parte de uma coluna date, time ou timestamp: hora (0-23), minuto do dia
+    (0-1439), dia (date, a partir de um timestamp) ou dia da semana (0 = domingo).
+    Retorna um DataFrame com a coluna colName_hour, colName_minute, colName_day ou
+    colName_weekday. Valores de outros tipos viram 0.
+    */
+    int colIdx = df.getColumnIndex(colName);
+    ColumnRef column = df.getColumn(colIdx);
+    string colType = df.getColumnType(colIdx);
+
+    static const char* suffixes[] = {"_hour", "_minute", "_day", "_weekday"};
+    string partName = colName + suffixes[part];
+    string partType = (part == DAY) ? "date" : "int";
+
+    size_t dataSize = column.size();
+    DataFrameBuilder builder({partName}, {partType}, dataSize);
+    ColumnBuilder& values = builder.column(0);
+    numThreads = max(1, min(numThreads, static_cast<int>(dataSize)));
+    size_t blockSize = (dataSize + numThreads - 1) / numThreads;
+    vector<future<void>> futures;
+
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, dataSize);
+        size_t end = min(start + blockSize, dataSize);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end]() {
+            for (size_t i = start; i < end; ++i) {
+                int result = 0;
+                if (const long long* micros = get_if<long long>(&column[i])) {
+                    if (part == HOUR) result = hour_of(*micros);
+                    else if (part == MINUTE) result = minute_of_day(*micros);
+                    else if (colType == "timestamp") result = (part == DAY) ? day_of(*micros) : weekday_from_days(day_of(*micros));
+                } else if (const int* days = get_if<int>(&column[i])) {
+                    if (part == DAY) result = *days;
+                    else if (part == WEEKDAY) result = weekday_from_days(*days);
+                }
+                values.set(i, result);
+            }
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    return builder.finish();
+}
+
+DataFrame filter_time_range(const DataFrameView& df, int id, int numThreads, const string& colName, const string& from, const string& to, ThreadPool& pool)
+{
+    /*
+    Linhas com from <= colName <= to em uma coluna date, time ou timestamp. Os limites
+    são lidos uma vez no tipo da coluna e a comparação é feita entre inteiros.
+    */
+    int colIdx = df.getColumnIndex(colName);
+    ColumnRef column = df.getColumn(colIdx);
+    string colType = df.getColumnType(colIdx);
+    if (colType != "date" && colType != "time" && colType != "timestamp") {
+        throw invalid_argument("Coluna '" + colName + "' não é do tipo date, time ou timestamp.");
+    }
+
+    // Limites como inteiros do tipo da coluna
+    auto toInteger = [&colType](const string& text) -> long long {
+        ElementType value = parseValue(text, colType);
+        if (const int* days = get_if<int>(&value)) return *days;
+        return get<long long>(value);
+    };
+    long long lower = toInteger(from);
+    long long upper = toInteger(to);
+
+    size_t dataSize = column.size();
+    numThreads = max(1, min(numThreads, static_cast<int>(dataSize)));
+    size_t blockSize = (dataSize + numThreads - 1) / numThreads;
+    vector<vector<size_t>> partialRows(numThreads);
+    vector<future<void>> futures;
+
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, dataSize);
+        size_t end = min(start + blockSize, dataSize);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            vector<size_t> rows;
+            for (size_t i = start; i < end; ++i) {
+                long long value;
+                if (const long long* micros = get_if<long long>(&column[i])) value = *micros;
+                else if (const int* days = get_if<int>(&column[i])) value = *days;
+                else continue;
+                if (value >= lower && value <= upper) rows.push_back(i);
+            }
+            partialRows[t] = move(rows);
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    vector<size_t> rows;
+    for (auto& partial : partialRows) rows.insert(rows.end(), partial.begin(), partial.end());
+    return gather_rows(df, rows, id, numThreads, pool);
+}
+
+DataFrame classify_accounts_parallel(DataFrame& df, int id, int numThreads, const string& idCol, const string& classFirst, const string& classSec, ThreadPool& tp) {
+    // Toma os índices das colunas relevantes
+    int idIdx = df.getColumnIndex(idCol);
+    int mediaIdx = df.getColumnIndex(classFirst);
+    int saldoIdx = df.getColumnIndex(classSec);
+
+    // Busca as colunas relevantes (compartilhadas com df, sem cópia; const para só ler)
+    const Column idCol_ = df.getColumn(idIdx);
+    const Column mediaCol = df.getColumn(mediaIdx);
+    const Column saldoCol = df.getColumn(saldoIdx);
+    double mediaDivisor = numericDivisor(df.getColumnType(mediaIdx));
+    double saldoDivisor = numericDivisor(df.getColumnType(saldoIdx));
+
+    int numRecords = df.getNumRecords();
+    numThreads = min(numThreads, static_cast<int>(numRecords));
+    int block_size = (numRecords + numThreads - 1) / numThreads;
+
+    // Promises comunicação de threads
+    vector<future<vector<ElementType>>> futuresIds;
+    vector<future<vector<ElementType>>> futuresCategorias;
+
+    // Para cada thread
+    for (int t = 0; t < numThreads; ++t) {
+        // Define os limites do bloco
+        int start = t * block_size;
+        int end = min(start + block_size, numRecords);
+        
+        // Define vetor de promessas para clientes e suas categorias
+        promise<vector<ElementType>> pIds;
+        promise<vector<ElementType>> pCategorias;
+        futuresIds.push_back(pIds.get_future());
+        futuresCategorias.push_back(pCategorias.get_future());
+
+        // Cada thread processa uma lambda, que processa um bloco
+        tp.enqueue(-id, 
+            [start, end, &idCol_, &mediaCol, &saldoCol, mediaDivisor, saldoDivisor, pIds = move(pIds), pCategorias = move(pCategorias)]() mutable {
+                // Cria um vetor local pra armazenar resultados do bloco
+                vector<ElementType> ids, categorias;
+    
+                // Para cada entrada do bloco
+                for (int i = start; i < end; ++i) {
+                    // Verifica se os valores estão no formato certo (médias e saldos podem ser float ou decimal)
+                    double media, saldo;
+                    if (!holds_alternative<int>(idCol_[i]) || 
+                        !numericValue(mediaCol[i], mediaDivisor, media) || 
+                        !numericValue(saldoCol[i], saldoDivisor, saldo))
+                        continue;
+                    
+                    // Se está tudo certo, extrai os valores 
+                    int account_id = get<int>(idCol_[i]);
+    
+                    // Classifica pessoas de acordo com as médias
+                    string categoria;
+                    if (media > 500) {
+                        categoria = "A";
+                    } else if (media >= 200 && media <= 500) {
+                        categoria = (saldo > 10000) ? "B" : "C";
+                    } else {
+                        categoria = "D";
+                    }
+    
+                    // E armazena os resultados
+                    ids.push_back(account_id);
+                    categorias.push_back(categoria);
+                }
+    
+                pIds.set_value(move(ids));
+                pCategorias.set_value(move(categorias));
+            }
+        );
+    }
+    tp.isReady(-id);
+
+    // Espera todas as threads e junta os resultados
+    vector<string> colNames = {"account_id", "categoria"};
+    vector<string> colTypes = {"int", "string"};
+    DataFrameBuilder result(colNames, colTypes);
+
+    // Para cada thread
+    for (int t = 0; t < numThreads; ++t) {
+        // Pegue os resultados dos futuros, acrescentados em ordem sem cópia
+        result.column(0).append(futuresIds[t].get());
+        result.column(1).append(futuresCategorias[t].get());
+    }
+
+    return result.finish();
+}
+
+DataFrame gather_rows(const DataFrameView& df, const vector<size_t>& rows, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Monta um novo DataFrame com as linhas de df na ordem dada por rows (posições na view).
+    As colunas do resultado são pré-dimensionadas e cada tarefa copia uma faixa de
+    linhas de todas elas.
+    */
+    vector<string> resultColTypes;
+    for (int j = 0; j < df.getNumCols(); ++j) {
+        resultColTypes.push_back(df.getColumnType(j));
+    }
+
+    size_t n = rows.size();
+    DataFrameBuilder result(df.getColumnNames(), resultColTypes, n);
+    if (n == 0) return result.finish();
+
+    numThreads = max(1, min(numThreads, static_cast<int>(n)));
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    vector<future<void>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = t * blockSize;
+        size_t end = min(start + blockSize, n);
+        if (start >= end) break;
+
+        futures.push_back(pool.enqueue(-id, [&, start, end]() {
+            for (size_t j = 0; j < result.getNumCols(); ++j) {
+                ColumnRef src = df.getColumn(static_cast<int>(j));
+                ColumnBuilder& dst = result.column(j);
+                for (size_t i = start; i < end; ++i) {
+                    dst.set(i, src[rows[i]]);
+                }
+            }
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    return result.finish();
+}
+
+DataFrame materialize(const DataFrameView& view, int id, int numThreads, ThreadPool& pool) {
+    // Copia as linhas e colunas da view para um novo DataFrame
+    vector<size_t> rows(view.getNumRecords());
+    iota(rows.begin(), rows.end(), 0);
+    return gather_rows(view, rows, id, numThreads, pool);
+}
+
+size_t sort_value_type(ColumnRef column, const string& colName, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Índice do tipo (no variant) dos valores de uma coluna de ordenação. Colunas com valores
+    de tipos diferentes (ex.: int e long long) não têm uma ordem comum e são rejeitadas.
+    */
+    size_t n = column.size();
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+    vector<future<unsigned>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        futures.push_back(pool.enqueue(-id, [&column, start, end]() {
+            unsigned mask = 0;
+            for (size_t i = start; i < end; ++i) mask |= 1u << column[i].index();
+            return mask;
+        }));
+    }
+    pool.isReady(-id);
+    unsigned mask = 0;
+    for (auto& f : futures) mask |= f.get();
+
+    if (mask & (mask - 1)) {
+        throw invalid_argument("Coluna de ordenação '" + colName + "' tem valores de tipos diferentes.");
+    }
+    size_t type = 0;
+    while (mask > 1) {
+        mask >>= 1;
+        type++;
+    }
+    return type;
+}
+
+inline bool numeric_sort_key(const ElementType& value, uint32_t& key) {
+    /*
+    Converte um valor numérico em uma chave de 32 bits cuja ordem sem sinal é a ordem
+    dos valores (int: inverte o bit de sinal; float: inverte todos os bits dos negativos
+    e o bit de sinal dos positivos). Retorna false para valores não numéricos.
+    */
+    if (const int* v = get_if<int>(&value)) {
+        key = static_cast<uint32_t>(*v) ^ 0x80000000u;
+    } else if (const float* f = get_if<float>(&value)) {
+        uint32_t bits;
+        memcpy(&bits, f, sizeof(bits));
+        key = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    } else if (const bool* b = get_if<bool>(&value)) {
+        key = *b ? 1u : 0u;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool radix_sort_keys(ColumnRef column, vector<uint64_t>& packed, bool ascending, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Guarda (chave normalizada << 32 | linha) em packed para o radix sort.
+    Retorna false se a coluna tiver algum valor que não seja int, float ou bool.
+    */
+    size_t n = column.size();
+    packed.resize(n);
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+    uint32_t flip = ascending ? 0u : 0xFFFFFFFFu;
+
+    vector<future<bool>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = t * blockSize;
+        size_t end = min(start + blockSize, n);
+        if (start >= end) break;
+
+        futures.push_back(pool.enqueue(-id, [&column, &packed, start, end, flip]() {
+            for (size_t i = start; i < end; ++i) {
+                uint32_t key;
+                if (!numeric_sort_key(column[i], key)) return false;
+                packed[i] = (static_cast<uint64_t>(key ^ flip) << 32) | i;
+            }
+            return true;
+        }));
+    }
+
+    pool.isReady(-id);
+    bool ok = true;
+    for (auto& f : futures) ok = f.get() && ok;
+    return ok;
+}
+
+void radix_sort_packed(vector<uint64_t>& packed, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Radix sort LSD paralelo sobre os 32 bits altos de packed, 8 bits por passada.
+    Em cada passada as threads montam o histograma do seu bloco, os deslocamentos são
+    obtidos por soma de prefixos (dígito, thread) e cada thread espalha o seu bloco.
+    A ordenação é estável, então linhas com a mesma chave mantêm a ordem original.
+    */
+    const int RADIX_BITS = 8;
+    const int NUM_BUCKETS = 1 << RADIX_BITS;
+    size_t n = packed.size();
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    vector<uint64_t> buffer(n);
+    vector<vector<size_t>> histograms(numThreads, vector<size_t>(NUM_BUCKETS));
+
+    for (int shift = 32; shift < 64; shift += RADIX_BITS) {
+        vector<future<void>> futures;
+        for (int t = 0; t < numThreads; ++t) {
+            size_t start = min(t * blockSize, n);
+            size_t end = min(start + blockSize, n);
+
+            futures.push_back(pool.enqueue(-id, [&, start, end, t, shift]() {
+                auto& hist = histograms[t];
+                fill(hist.begin(), hist.end(), 0);
+                for (size_t i = start; i < end; ++i) {
+                    hist[(packed[i] >> shift) & (NUM_BUCKETS - 1)]++;
+                }
+            }));
+        }
+        pool.isReady(-id);
+        for (auto& f : futures) f.get();
+
+        // Se todas as chaves têm o mesmo dígito a passada não muda nada
+        bool trivial = false;
+        for (int d = 0; d < NUM_BUCKETS && !trivial; ++d) {
+            size_t total = 0;
+            for (int t = 0; t < numThreads; ++t) total += histograms[t][d];
+            trivial = (total == n);
+        }
+        if (trivial) continue;
+
+        // Deslocamentos: dígito mais significativo, depois thread (preserva estabilidade)
+        size_t offset = 0;
+        for (int d = 0; d < NUM_BUCKETS; ++d) {
+            for (int t = 0; t < numThreads; ++t) {
+                size_t count = histograms[t][d];
+                histograms[t][d] = offset;
+                offset += count;
+            }
+        }
+
+        futures.clear();
+        for (int t = 0; t < numThreads; ++t) {
+            size_t start = min(t * blockSize, n);
+            size_t end = min(start + blockSize, n);
+
+            futures.push_back(pool.enqueue(-id, [&, start, end, t, shift]() {
+                auto& positions = histograms[t];
+                for (size_t i = start; i < end; ++i) {
+                    buffer[positions[(packed[i] >> shift) & (NUM_BUCKETS - 1)]++] = packed[i];
+                }
+            }));
+        }
+        pool.isReady(-id);
+        for (auto& f : futures) f.get();
+
+        packed.swap(buffer);
+    }
+}
+
+bool radix_sort_wide(ColumnRef column, vector<size_t>& order, bool ascending, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Radix sort LSD paralelo para colunas long long (time, timestamp, decimal), cujas
+    chaves não cabem nos 32 bits de packed. As chaves são rebaseadas pelo mínimo (ou pelo
+    máximo, em ordem decrescente), então as passadas de 8 bits só cobrem os bytes do
+    intervalo dos valores; o índice da linha fica em um vetor à parte.
+    Retorna false se a coluna tiver algum valor que não seja long long.
+    */
+    const int RADIX_BITS = 8;
+    const int NUM_BUCKETS = 1 << RADIX_BITS;
+    size_t n = column.size();
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    // Mínimo e máximo de cada bloco (e verificação do tipo)
+    vector<long long> localMin(numThreads, numeric_limits<long long>::max()), localMax(numThreads, numeric_limits<long long>::min());
+    vector<future<bool>> checks;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        checks.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            for (size_t i = start; i < end; ++i) {
+                const long long* value = get_if<long long>(&column[i]);
+                if (!value) return false;
+                localMin[t] = min(localMin[t], *value);
+                localMax[t] = max(localMax[t], *value);
+            }
+            return true;
+        }));
+    }
+    pool.isReady(-id);
+    bool wide = true;
+    for (auto& f : checks) wide = f.get() && wide;
+    if (!wide) return false;
+
+    uint64_t low = static_cast<uint64_t>(*min_element(localMin.begin(), localMin.end()));
+    uint64_t high = static_cast<uint64_t>(*max_element(localMax.begin(), localMax.end()));
+    uint64_t range = high - low;
+
+    // Chaves sem sinal a partir do mínimo (crescente) ou do máximo (decrescente)
+    vector<uint64_t> keys(n), keyBuffer(n);
+    vector<uint32_t> rows(n), rowBuffer(n);
+    vector<future<void>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end]() {
+            for (size_t i = start; i < end; ++i) {
+                uint64_t value = static_cast<uint64_t>(get<long long>(column[i]));
+                keys[i] = ascending ? value - low : high - value;
+                rows[i] = static_cast<uint32_t>(i);
+            }
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    vector<vector<size_t>> histograms(numThreads, vector<size_t>(NUM_BUCKETS));
+    for (int shift = 0; shift < 64 && (range >> shift) != 0; shift += RADIX_BITS) {
+        futures.clear();
+        for (int t = 0; t < numThreads; ++t) {
+            size_t start = min(t * blockSize, n);
+            size_t end = min(start + blockSize, n);
+
+            futures.push_back(pool.enqueue(-id, [&, start, end, t, shift]() {
+                auto& hist = histograms[t];
+                fill(hist.begin(), hist.end(), 0);
+                for (size_t i = start; i < end; ++i) {
+                    hist[(keys[i] >> shift) & (NUM_BUCKETS - 1)]++;
+                }
+            }));
+        }
+        pool.isReady(-id);
+        for (auto& f : futures) f.get();
+
+        // Deslocamentos: dígito mais significativo, depois thread (preserva estabilidade)
+        size_t offset = 0;
+        for (int d = 0; d < NUM_BUCKETS; ++d) {
+            for (int t = 0; t < numThreads; ++t) {
+                size_t count = histograms[t][d];
+                histograms[t][d] = offset;
+                offset += count;
+            }
+        }
+
+        futures.clear();
+        for (int t = 0; t < numThreads; ++t) {
+            size_t start = min(t * blockSize, n);
+            size_t end = min(start + blockSize, n);
+
+            futures.push_back(pool.enqueue(-id, [&, start, end, t, shift]() {
+                auto& positions = histograms[t];
+                for (size_t i = start; i < end; ++i) {
+                    size_t pos = positions[(keys[i] >> shift) & (NUM_BUCKETS - 1)]++;
+                    keyBuffer[pos] = keys[i];
+                    rowBuffer[pos] = rows[i];
+                }
+            }));
+        }
+        pool.isReady(-id);
+        for (auto& f : futures) f.get();
+
+        keys.swap(keyBuffer);
+        rows.swap(rowBuffer);
+    }
+
+    order.assign(rows.begin(), rows.end());
+    return true;
+}
+
+bool wide_sort_codes(ColumnRef column, uint32_t flip, vector<uint32_t>& codes, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Códigos de ordenação para colunas long long (time, timestamp, decimal), que não cabem
+    em 32 bits: cada valor distinto recebe a sua posição na lista ordenada dos distintos.
+    Retorna false se a coluna tiver algum valor que não seja long long.
+    */
+    size_t n = column.size();
+    codes.assign(n, 0);
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    vector<vector<long long>> localValues(numThreads);
+    vector<future<bool>> checks;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        checks.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            vector<long long> values;
+            values.reserve(end - start);
+            for (size_t i = start; i < end; ++i) {
+                const long long* value = get_if<long long>(&column[i]);
+                if (!value) return false;
+                values.push_back(*value);
+            }
+            sort(values.begin(), values.end());
+            values.erase(unique(values.begin(), values.end()), values.end());
+            localValues[t] = move(values);
+            return true;
+        }));
+    }
+    pool.isReady(-id);
+    bool wide = true;
+    for (auto& f : checks) wide = f.get() && wide;
+    if (!wide) return false;
+
+    vector<long long> distinct;
+    for (auto& values : localValues) {
+        vector<long long> merged;
+        merged.reserve(distinct.size() + values.size());
+        set_union(distinct.begin(), distinct.end(), values.begin(), values.end(), back_inserter(merged));
+        distinct = move(merged);
+        vector<long long>().swap(values);
+    }
+
+    vector<future<void>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end]() {
+            for (size_t i = start; i < end; ++i) {
+                size_t rank = lower_bound(distinct.begin(), distinct.end(), get<long long>(column[i])) - distinct.begin();
+                codes[i] = static_cast<uint32_t>(rank) ^ flip;
+            }
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    return true;
+}
+
+vector<uint32_t> string_sort_codes(ColumnRef column, uint32_t flip, vector<uint32_t>& codes, int id, int numThreads, ThreadPool& pool) {
+    /*Códigos de uma coluna de strings: posição de cada valor no dicionário ordenado dos distintos.*/
+    size_t n = column.size();
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    // Dicionário: valores distintos de cada bloco, unidos e ordenados
+    vector<FlatHashMap<string, uint32_t>> localDicts(numThreads);
+    vector<future<void>> dictFutures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        dictFutures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            for (size_t i = start; i < end; ++i) {
+                localDicts[t][variantToString(column[i])] = 0;
+            }
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : dictFutures) f.get();
+
+    FlatHashMap<string, uint32_t> dictionary;
+    for (auto& localDict : localDicts) {
+        dictionary.reserve(localDict.size());
+        for (const auto& [value, code] : localDict) dictionary[value] = 0;
+        localDict.clear();
+    }
+
+    vector<const string*> sortedValues;
+    sortedValues.reserve(dictionary.size());
+    for (const auto& [value, code] : dictionary) sortedValues.push_back(&value);
+    sort(sortedValues.begin(), sortedValues.end(), [](const string* a, const string* b) { return *a < *b; });
+    for (size_t rank = 0; rank < sortedValues.size(); ++rank) {
+        *dictionary.find(*sortedValues[rank]) = static_cast<uint32_t>(rank);
+    }
+
+    // Troca cada valor pelo seu código (o dicionário só é lido a partir daqui)
+    dictFutures.clear();
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        dictFutures.push_back(pool.enqueue(-id, [&, start, end, flip]() {
+            for (size_t i = start; i < end; ++i) {
+                const string* value = get_if<string>(&column[i]);
+                codes[i] = *dictionary.find(value ? *value : variantToString(column[i])) ^ flip;
+            }
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : dictFutures) f.get();
+
+    return codes;
+}
+
+vector<uint32_t> sort_codes(ColumnRef column, const string& colName, bool ascending, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Converte uma coluna chave em códigos de 32 bits que preservam a ordem dos valores.
+    Colunas int, float e bool usam numeric_sort_key; colunas long long (time, timestamp,
+    decimal) e strings viram a posição do valor no dicionário ordenado dos valores
+    distintos. Em ordem decrescente os códigos são invertidos. Lança invalid_argument
+    se a coluna misturar tipos de valores.
+    */
+    size_t n = column.size();
+    vector<uint32_t> codes(n);
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+    uint32_t flip = ascending ? 0u : 0xFFFFFFFFu;
+    size_t valueType = sort_value_type(column, colName, id, numThreads, pool);
+
+    // Colunas de 64 bits (time, timestamp, decimal): posição no dicionário ordenado dos valores
+    if (valueType == 4) {
+        wide_sort_codes(column, flip, codes, id, numThreads, pool);
+        return codes;
+    }
+    if (valueType == 3) return string_sort_codes(column, flip, codes, id, numThreads, pool);
+
+    // Numéricas, bloco a bloco
+    vector<future<bool>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        futures.push_back(pool.enqueue(-id, [&column, &codes, start, end, flip]() {
+            for (size_t i = start; i < end; ++i) {
+                if (!numeric_sort_key(column[i], codes[i])) return false;
+                codes[i] ^= flip;
+            }
+            return true;
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+    return codes;
+}
+
+
+struct RowComparator {
+    /*
+    Compara linhas pelas chaves de ordenação. As duas primeiras chaves ficam juntas em
+    um prefixo de 64 bits; as demais só são consultadas em caso de empate. O índice da
+    linha desempata no final, o que torna a ordenação estável.
+    */
+    vector<uint64_t> prefix;
+    vector<vector<uint32_t>> rest;
+
+    bool operator()(size_t a, size_t b) const {
+        if (prefix[a] != prefix[b]) return prefix[a] < prefix[b];
+        for (const auto& codes : rest) {
+            if (codes[a] != codes[b]) return codes[a] < codes[b];
+        }
+        return a < b;
+    }
+};
+
+size_t merge_path_split(const size_t* a, size_t lenA, const size_t* b, size_t lenB, size_t diagonal, const RowComparator& less) {
+    /*
+    Busca binária na diagonal do caminho de merge: retorna quantos elementos de a
+    estão entre os 'diagonal' primeiros elementos da sequência fundida.
+    */
+    size_t lo = diagonal > lenB ? diagonal - lenB : 0;
+    size_t hi = min(diagonal, lenA);
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (less(a[mid], b[diagonal - mid - 1])) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+vector<size_t> parallel_merge_sort(size_t n, const RowComparator& less, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Ordena os índices 0..n-1: cada thread ordena um bloco e, em seguida, os blocos são
+    fundidos dois a dois. Cada fusão é dividida pelo caminho de merge (merge path) em
+    segmentos independentes, de modo que todas as threads trabalham em todas as rodadas.
+    */
+    vector<size_t> current(n), next(n);
+    iota(current.begin(), current.end(), 0);
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    vector<pair<size_t, size_t>> runs;
+    vector<future<void>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+        if (start >= end) break;
+        runs.emplace_back(start, end);
+
+        futures.push_back(pool.enqueue(-id, [&current, &less, start, end]() {
+            sort(current.begin() + start, current.begin() + end, cref(less));
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    while (runs.size() > 1) {
+        vector<pair<size_t, size_t>> mergedRuns;
+        size_t numPairs = runs.size() / 2;
+        size_t segments = max<size_t>(1, numThreads / numPairs);
+        futures.clear();
+
+        for (size_t r = 0; r + 1 < runs.size(); r += 2) {
+            size_t beginA = runs[r].first, lenA = runs[r].second - runs[r].first;
+            size_t beginB = runs[r + 1].first, lenB = runs[r + 1].second - runs[r + 1].first;
+            size_t total = lenA + lenB;
+            mergedRuns.emplace_back(beginA, beginA + total);
+
+            for (size_t seg = 0; seg < segments; ++seg) {
+                size_t diagStart = total * seg / segments;
+                size_t diagEnd = total * (seg + 1) / segments;
+                if (diagStart >= diagEnd) continue;
+
+                futures.push_back(pool.enqueue(-id, [&, beginA, lenA, beginB, lenB, diagStart, diagEnd]() {
+                    const size_t* a = current.data() + beginA;
+                    const size_t* b = current.data() + beginB;
+                    size_t i = merge_path_split(a, lenA, b, lenB, diagStart, less);
+                    size_t iEnd = merge_path_split(a, lenA, b, lenB, diagEnd, less);
+                    size_t j = diagStart - i;
+                    size_t jEnd = diagEnd - iEnd;
+                    merge(a + i, a + iEnd, b + j, b + jEnd, next.begin() + beginA + diagStart, cref(less));
+                }));
+            }
+        }
+
+        // Bloco sem par é apenas copiado
+        if (runs.size() % 2 == 1) {
+            auto [start, end] = runs.back();
+            copy(current.begin() + start, current.begin() + end, next.begin() + start);
+            mergedRuns.push_back(runs.back());
+        }
+
+        pool.isReady(-id);
+        for (auto& f : futures) f.get();
+
+        current.swap(next);
+        runs = move(mergedRuns);
+    }
+
+    return current;
+}
+
+DataFrame sort_by_columns_parallel(const DataFrameView& df, int id, int numThreads, const vector<string>& keyCols, const vector<bool>& ascending, ThreadPool& pool) {
+    /*
+    Ordena o DataFrame por várias colunas, cada uma com sua direção (ascending[k]).
+    Aceita colunas numéricas e de strings (comparadas por códigos de dicionário).
+    Lança invalid_argument se uma coluna chave misturar tipos de valores.
+    */
+    if (keyCols.empty() || keyCols.size() != ascending.size()) {
+        throw invalid_argument("É preciso informar uma direção para cada coluna de ordenação.");
+    }
+
+    size_t n = df.getNumRecords();
+    if (n == 0) return gather_rows(df, {}, id, numThreads, pool);
+    numThreads = min(numThreads, static_cast<int>(n));
+
+    // Uma única chave numérica: radix sort (32 bits ou, para long long, 64 bits)
+    vector<uint64_t> packed;
+    if (keyCols.size() == 1) {
+        ColumnRef key = df.getColumn(df.getColumnIndex(keyCols[0]));
+        size_t valueType = sort_value_type(key, keyCols[0], id, numThreads, pool);
+        if (valueType == 4) {
+            vector<size_t> finalIndices;
+            if (radix_sort_wide(key, finalIndices, ascending[0], id, numThreads, pool)) {
+                return gather_rows(df, finalIndices, id, numThreads, pool);
+            }
+        } else if (valueType != 3 && radix_sort_keys(key, packed, ascending[0], id, numThreads, pool)) {
+            radix_sort_packed(packed, id, numThreads, pool);
+            vector<size_t> finalIndices(n);
+            for (size_t i = 0; i < n; ++i) {
+                finalIndices[i] = static_cast<uint32_t>(packed[i]);
+            }
+            return gather_rows(df, finalIndices, id, numThreads, pool);
+        }
+    }
 
-    vector<ElementType> colHour;
-    for (size_t i=0; i<hoursColumn.size(); i++)
-    {
-        const auto& hour = hoursColumn[i];
-        colHour.push_back(hour);
+    // Códigos de cada chave; as duas primeiras formam o prefixo de 64 bits
+    vector<vector<uint32_t>> codes;
+    for (size_t k = 0; k < keyCols.size(); ++k) {
+        codes.push_back(sort_codes(df.getColumn(df.getColumnIndex(keyCols[k])), keyCols[k], ascending[k], id, numThreads, pool));
     }
 
-    DataFrame dfHours(colNames, colTypes);
-    dfHours.addColumn(colHour, nameColumn, typeColumn);
+    RowComparator less;
+    less.prefix.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t second = codes.size() > 1 ? codes[1][i] : 0;
+        less.prefix[i] = (static_cast<uint64_t>(codes[0][i]) << 32) | second;
+    }
+    for (size_t k = 2; k < codes.size(); ++k) {
+        less.rest.push_back(move(codes[k]));
+    }
 
-    return dfHours;
+    vector<size_t> finalIndices = parallel_merge_sort(n, less, id, numThreads, pool);
+    return gather_rows(df, finalIndices, id, numThreads, pool);
 }
 
-DataFrame num_transac_by_hour(const DataFrame& df, int id, int numThreads, const string& hourCol, int numDays, ThreadPool& pool)
-{
-    DataFrame hours = get_hour_by_time(df, id, numThreads, hourCol, pool);
-    DataFrame counts = count_values(hours, id, numThreads, hourCol, numDays, pool);
-    
-    return counts;
+DataFrame sort_by_column_parallel(const DataFrameView& df, int id, int numThreads, const string& keyCol, ThreadPool& pool, bool ascending) {
+    return sort_by_columns_parallel(df, id, numThreads, {keyCol}, {ascending}, pool);
 }
 
-DataFrame classify_accounts_parallel(DataFrame& df, int id, int numThreads, const string& idCol, const string& classFirst, const string& classSec, ThreadPool& tp) {
-    // Toma os índices das colunas relevantes
-    int idIdx = df.getColumnIndex(idCol);
-    int mediaIdx = df.getColumnIndex(classFirst);
-    int saldoIdx = df.getColumnIndex(classSec);
+vector<double> concat_blocks(vector<vector<double>>& blocks, int id, ThreadPool& pool) {
+    /*
+    Junta os vetores produzidos por cada thread em um único vetor contíguo, com uma
+    cópia em paralelo por bloco. Os blocos são liberados durante a cópia.
+    */
+    // Um único bloco completo é devolvido sem cópia
+    if (blocks.size() == 1) return move(blocks[0]);
 
-    // Busca as colunas relevantes
-    auto idCol_ = df.getColumn(idIdx);
-    auto mediaCol = df.getColumn(mediaIdx);
-    auto saldoCol = df.getColumn(saldoIdx);
+    vector<size_t> offsets(blocks.size() + 1, 0);
+    for (size_t t = 0; t < blocks.size(); ++t) offsets[t + 1] = offsets[t] + blocks[t].size();
 
-    int numRecords = df.getNumRecords();
-    numThreads = min(numThreads, static_cast<int>(numRecords));
-    int block_size = (numRecords + numThreads - 1) / numThreads;
+    vector<double> values(offsets.back());
+    vector<future<void>> futures;
+    for (size_t t = 0; t < blocks.size(); ++t) {
+        if (blocks[t].empty()) continue;
+        futures.push_back(pool.enqueue(-id, [&, t]() {
+            copy(blocks[t].begin(), blocks[t].end(), values.begin() + offsets[t]);
+            vector<double>().swap(blocks[t]);
+        }));
+    }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
 
-    // Promises comunicação de threads
-    vector<future<vector<ElementType>>> futuresIds;
-    vector<future<vector<ElementType>>> futuresCategorias;
+    return values;
+}
 
-    // Para cada thread
+vector<double> extract_numeric_column(const DataFrameView& df, const string& colName, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Copia os valores numéricos (int, float, decimal) de uma coluna para um vetor contíguo de double.
+    Valores de outros tipos são ignorados, como em calculateMeanParallel.
+    */
+    int colIdx = df.getColumnIndex(colName);
+    const auto& column = df.getColumn(colIdx);
+    double divisor = numericDivisor(df.getColumnType(colIdx));
+    size_t n = column.size();
+    if (n == 0) return {};
+    numThreads = max(1, min(numThreads, static_cast<int>(n)));
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    vector<vector<double>> blocks(numThreads);
+    vector<future<void>> futures;
     for (int t = 0; t < numThreads; ++t) {
-        // Define os limites do bloco
-        int start = t * block_size;
-        int end = min(start + block_size, numRecords);
-        
-        // Define vetor de promessas para clientes e suas categorias
-        promise<vector<ElementType>> pIds;
-        promise<vector<ElementType>> pCategorias;
-        futuresIds.push_back(pIds.get_future());
-        futuresCategorias.push_back(pCategorias.get_future());
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
 
-        // Cada thread processa uma lambda, que processa um bloco
-        tp.enqueue(-id, 
-            [start, end, &idCol_, &mediaCol, &saldoCol, pIds = move(pIds), pCategorias = move(pCategorias)]() mutable {
-                // Cria um vetor local pra armazenar resultados do bloco
-                vector<ElementType> ids, categorias;
-    
-                // Para cada entrada do bloco
-                for (int i = start; i < end; ++i) {
-                    // Verifica se os valores estão no formato certo
-                    if (!holds_alternative<int>(idCol_[i]) || 
-                        !holds_alternative<float>(mediaCol[i]) || 
-                        !holds_alternative<float>(saldoCol[i]))
-                        continue;
-                    
-                    // Se está tudo certo, extrai os valores 
-                    int account_id = get<int>(idCol_[i]);
-                    float media = get<float>(mediaCol[i]);
-                    float saldo = get<float>(saldoCol[i]);
-    
-                    // Classifica pessoas de acordo com as médias
-                    string categoria;
-                    if (media > 500) {
-                        categoria = "A";
-                    } else if (media >= 200 && media <= 500) {
-                        categoria = (saldo > 10000) ? "B" : "C";
-                    } else {
-                        categoria = "D";
-                    }
-    
-                    // E armazena os resultados
-                    ids.push_back(account_id);
-                    categorias.push_back(categoria);
-                }
-    
-                pIds.set_value(move(ids));
-                pCategorias.set_value(move(categorias));
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            vector<double> local;
+            local.reserve(end - start);
+            double value;
+            for (size_t i = start; i < end; ++i) {
+                if (numericValue(column[i], divisor, value)) local.push_back(value);
             }
-        );
+            blocks[t] = move(local);
+        }));
     }
-    tp.isReady(-id);
-
-    // Espera todas as threads e junta os resultados
-    vector<string> colNames = {"account_id", "categoria"};
-    vector<string> colTypes = {"int", "string"};
-    DataFrame result(colNames, colTypes);
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
 
-    // Para cada thread
-    for (int t = 0; t < numThreads; ++t) {
-        // Pegue os resultados dos futuros
-        auto ids = futuresIds[t].get();
-        auto categorias = futuresCategorias[t].get();
+    return concat_blocks(blocks, id, pool);
+}
 
-        for (size_t i = 0; i < ids.size(); ++i) {
-            result.columns[0].push_back(ids[i]);
-            result.columns[1].push_back(categorias[i]);
-            result.numRecords++;
+vector<double> select_ranks(const vector<double>& values, const vector<size_t>& ranks, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Retorna, para cada posição em ranks, o valor que estaria nessa posição se values
+    estivesse ordenado, sem ordená-lo. Os valores são distribuídos em baldes definidos por
+    pivôs amostrados (contagem paralela), e só os baldes que contêm alguma das posições
+    pedidas são copiados e resolvidos com nth_element. O custo total é linear em n.
+    */
+    const size_t NUM_BUCKETS = 1024;
+    const size_t SAMPLES_PER_BUCKET = 32;
+    const size_t SMALL_INPUT = 1 << 15;
+
+    size_t n = values.size();
+    vector<double> result(ranks.size());
+    if (n == 0) return result;
+
+    // Entradas pequenas: nth_element direto
+    if (n <= SMALL_INPUT) {
+        vector<double> copyValues(values);
+        for (size_t r = 0; r < ranks.size(); ++r) {
+            nth_element(copyValues.begin(), copyValues.begin() + ranks[r], copyValues.end());
+            result[r] = copyValues[ranks[r]];
         }
+        return result;
     }
 
-    return result;
-}
+    // Pivôs a partir de uma amostra espaçada
+    size_t sampleSize = min(n, NUM_BUCKETS * SAMPLES_PER_BUCKET);
+    vector<double> sample(sampleSize);
+    for (size_t i = 0; i < sampleSize; ++i) sample[i] = values[i * (n / sampleSize)];
+    sort(sample.begin(), sample.end());
+    vector<double> splitters(NUM_BUCKETS - 1);
+    for (size_t b = 0; b + 1 < NUM_BUCKETS; ++b) splitters[b] = sample[(b + 1) * sampleSize / NUM_BUCKETS];
 
-DataFrame sort_by_column_parallel(const DataFrame& df, int id, int numThreads, const string& keyCol, ThreadPool& pool, bool ascending) {
-    size_t keyIdx = df.getColumnIndex(keyCol);
-    const auto& keyColumn = df.columns[keyIdx];
-    size_t n = df.getNumRecords();
-    vector<size_t> indices(n);
-    iota(indices.begin(), indices.end(), 0);
-    
-    numThreads = min(numThreads, static_cast<int>(n));
-    size_t block_size = (n + numThreads - 1) / numThreads;
-    
-    vector<vector<size_t>> sortedBlocks(numThreads);
-    vector<promise<void>> promises(numThreads);
+    auto bucketOf = [&splitters](double v) {
+        return static_cast<uint16_t>(upper_bound(splitters.begin(), splitters.end(), v) - splitters.begin());
+    };
+
+    // Contagem paralela por balde
+    numThreads = max(1, min(numThreads, static_cast<int>(n)));
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+    vector<uint16_t> bucketIds(n);
+    vector<vector<size_t>> histograms(numThreads, vector<size_t>(NUM_BUCKETS, 0));
     vector<future<void>> futures;
-    
-    // Relaciona promessas e futuros
-    for (auto& p : promises) {
-        futures.push_back(p.get_future());
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            auto& hist = histograms[t];
+            for (size_t i = start; i < end; ++i) {
+                uint16_t b = bucketOf(values[i]);
+                bucketIds[i] = b;
+                hist[b]++;
+            }
+        }));
     }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
 
-    // Lança as tarefas no pool
-    for (int i = 0; i < numThreads; ++i) {
-        size_t start = min(i * block_size, n);
-        size_t end = min(start + block_size, n);
-
-        pool.enqueue(-id, [&, start, end, i]() {
-            vector<size_t> local(indices.begin() + start, indices.begin() + end);
-            sort(local.begin(), local.end(), [&](size_t a, size_t b) {
-                if (holds_alternative<int>(keyColumn[a]) && holds_alternative<int>(keyColumn[b])) {
-                    return ascending ? get<int>(keyColumn[a]) < get<int>(keyColumn[b])
-                                     : get<int>(keyColumn[a]) > get<int>(keyColumn[b]);
-                }
-                if (holds_alternative<float>(keyColumn[a]) && holds_alternative<float>(keyColumn[b])) {
-                    return ascending ? get<float>(keyColumn[a]) < get<float>(keyColumn[b])
-                                     : get<float>(keyColumn[a]) > get<float>(keyColumn[b]);
-                }
-                return false;
-            });
-            sortedBlocks[i] = move(local);
-            promises[i].set_value();
-        });
+    vector<size_t> bucketStart(NUM_BUCKETS + 1, 0);
+    for (size_t b = 0; b < NUM_BUCKETS; ++b) {
+        size_t total = 0;
+        for (int t = 0; t < numThreads; ++t) total += histograms[t][b];
+        bucketStart[b + 1] = bucketStart[b] + total;
+    }
+
+    // Balde de cada posição pedida
+    vector<int> slotOfBucket(NUM_BUCKETS, -1);
+    vector<size_t> neededBuckets;
+    vector<size_t> rankBucket(ranks.size());
+    for (size_t r = 0; r < ranks.size(); ++r) {
+        size_t b = upper_bound(bucketStart.begin(), bucketStart.end(), ranks[r]) - bucketStart.begin() - 1;
+        rankBucket[r] = b;
+        if (slotOfBucket[b] < 0) {
+            slotOfBucket[b] = neededBuckets.size();
+            neededBuckets.push_back(b);
+        }
     }
 
+    // Cada thread copia os elementos dos baldes necessários do seu bloco
+    vector<vector<vector<double>>> collected(numThreads, vector<vector<double>>(neededBuckets.size()));
+    futures.clear();
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            for (size_t s = 0; s < neededBuckets.size(); ++s) {
+                collected[t][s].reserve(histograms[t][neededBuckets[s]]);
+            }
+            for (size_t i = start; i < end; ++i) {
+                int slot = slotOfBucket[bucketIds[i]];
+                if (slot >= 0) collected[t][slot].push_back(values[i]);
+            }
+        }));
+    }
     pool.isReady(-id);
+    for (auto& f : futures) f.get();
 
+    // Seleção dentro de cada balde necessário
+    futures.clear();
+    for (size_t s = 0; s < neededBuckets.size(); ++s) {
+        futures.push_back(pool.enqueue(-id, [&, s]() {
+            size_t b = neededBuckets[s];
+            vector<double> bucket;
+            bucket.reserve(bucketStart[b + 1] - bucketStart[b]);
+            for (int t = 0; t < numThreads; ++t) {
+                bucket.insert(bucket.end(), collected[t][s].begin(), collected[t][s].end());
+            }
+            for (size_t r = 0; r < ranks.size(); ++r) {
+                if (rankBucket[r] != b) continue;
+                size_t localRank = ranks[r] - bucketStart[b];
+                nth_element(bucket.begin(), bucket.begin() + localRank, bucket.end());
+                result[r] = bucket[localRank];
+            }
+        }));
+    }
+    pool.isReady(-id);
     for (auto& f : futures) f.get();
 
-    // Merge com heap
-    auto cmp = [&](pair<size_t, int> a, pair<size_t, int> b) {
-        float fvalA = holds_alternative<int>(keyColumn[a.first]) ? static_cast<float>(get<int>(keyColumn[a.first])) : get<float>(keyColumn[a.first]);
-        float fvalB = holds_alternative<int>(keyColumn[b.first]) ? static_cast<float>(get<int>(keyColumn[b.first])) : get<float>(keyColumn[b.first]);
-        return ascending ? fvalA > fvalB : fvalA < fvalB;
-    };
-    priority_queue<pair<size_t, int>, vector<pair<size_t, int>>, decltype(cmp)> pq(cmp);
-    vector<size_t> pos(numThreads, 0);
+    return result;
+}
 
-    for (int i = 0; i < numThreads; ++i)
-        if (!sortedBlocks[i].empty())
-            pq.emplace(sortedBlocks[i][0], i);
+string quantile_label(double q) {
+    // Rótulo usado para cada quantil no resultado de getQuantiles
+    if (q == 0.0) return "min";
+    if (q == 1.0) return "max";
+    if (q == 0.5) return "median";
+    return "Q" + to_string(static_cast<int>(q * 100));
+}
 
-    vector<size_t> finalIndices;
-    while (!pq.empty()) {
-        auto [idx, block] = pq.top();
-        pq.pop();
-        finalIndices.push_back(idx);
-        if (++pos[block] < sortedBlocks[block].size())
-            pq.emplace(sortedBlocks[block][pos[block]], block);
+vector<double> exact_quantiles(const vector<double>& values, const vector<double>& quantiles, int id, int numThreads, ThreadPool& pool) {
+    /*
+    Quantis exatos de values, com interpolação linear entre as posições vizinhas.
+    values não precisa estar ordenado; as posições são obtidas por select_ranks.
+    */
+    size_t n = values.size();
+    vector<double> result(quantiles.size(), 0.0);
+    if (n == 0) return result;
+
+    // Posições inferior e superior de cada quantil
+    vector<size_t> ranks;
+    for (double q : quantiles) {
+        double pos = q * (n - 1);
+        ranks.push_back(static_cast<size_t>(floor(pos)));
+        ranks.push_back(static_cast<size_t>(ceil(pos)));
     }
+    vector<double> selected = select_ranks(values, ranks, id, numThreads, pool);
 
-    // Construir metadados do DataFrame resultante
-    vector<string> resultColNames;
-    vector<string> resultColTypes;
+    for (size_t k = 0; k < quantiles.size(); ++k) {
+        double pos = quantiles[k] * (n - 1);
+        size_t lower = ranks[2 * k];
+        size_t upper = ranks[2 * k + 1];
+        double lowerVal = selected[2 * k];
+        double upperVal = selected[2 * k + 1];
 
-    for (const auto& name : df.colNames) {
-        resultColNames.push_back(name);
-        resultColTypes.push_back(df.colTypes.at(name));
+        // Posição exata ou interpolação entre as posições vizinhas
+        result[k] = (lower == upper) ? lowerVal : (upper - pos) * lowerVal + (pos - lower) * upperVal;
     }
+    return result;
+}
 
-    DataFrame result(resultColNames, resultColTypes);
-    for (size_t i : finalIndices) {
-        vector<string> record;
-        for (size_t j = 0; j < df.getNumCols(); ++j) {
-            const auto& val = df.columns[j][i];
-            if (holds_alternative<int>(val)) {
-                record.push_back(to_string(get<int>(val)));
-            } else if (holds_alternative<float>(val)) {
-                record.push_back(to_string(get<float>(val)));
-            } else if (holds_alternative<bool>(val)) {
-                record.push_back(get<bool>(val) ? "true" : "false");
-            } else if (holds_alternative<string>(val)) {
-                record.push_back(get<string>(val));
-            }
-        }
-        result.addRecord(record);
+unordered_map<string, ElementType> getQuantiles(const DataFrameView& df, int id, int numThreads, const string& colName, const vector<double>& quantiles, ThreadPool& pool) {
+    /*
+    Quantis exatos (com interpolação linear entre posições vizinhas) por seleção,
+    lendo apenas a coluna alvo em vez de ordenar o DataFrame inteiro.
+    */
+    unordered_map<string, ElementType> result;
+    bool isInt = df.getColumnType(df.getColumnIndex(colName)) == "int";
+
+    vector<double> values = extract_numeric_column(df, colName, id, numThreads, pool);
+    vector<double> computed = exact_quantiles(values, quantiles, id, numThreads, pool);
+
+    for (size_t k = 0; k < quantiles.size(); ++k) {
+        string label = quantile_label(quantiles[k]);
+        if (values.empty()) result[label] = ElementType{};
+        else if (isInt) result[label] = static_cast<int>(computed[k]);
+        else result[label] = static_cast<float>(computed[k]);
     }
 
     return result;
 }
 
-unordered_map<string, ElementType> getQuantiles(const DataFrame& df, int id, int numThreads, const string& colName, const vector<double>& quantiles, ThreadPool& pool) {
-    unordered_map<string, ElementType> result;
+KLLSketch build_quantile_sketch(const DataFrameView& df, int id, int numThreads, const string& colName, ThreadPool& pool, int k) {
+    /*
+    Monta um sketch KLL dos valores numéricos (int, float) de uma coluna: cada thread
+    resume o seu bloco e os sketches parciais são fundidos. O resultado pode continuar
+    recebendo valores com update ou ser fundido com sketches de outros lotes.
+    */
+    int colIdx = df.getColumnIndex(colName);
+    const auto& column = df.getColumn(colIdx);
+    double divisor = numericDivisor(df.getColumnType(colIdx));
+    size_t n = column.size();
+    if (n == 0) return KLLSketch(k);
+    numThreads = max(1, min(numThreads, static_cast<int>(n)));
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    vector<KLLSketch> partials(numThreads, KLLSketch(k));
+    vector<future<void>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
 
-    DataFrame sortedDf = sort_by_column_parallel(df, id, numThreads, colName, pool, true);
-    const auto& sortedCol = sortedDf.getColumn(sortedDf.getColumnIndex(colName));
-    int n = sortedDf.getNumRecords();
-
-    // função para calcular os quantis
-    auto getQuantileValue = [&](double quantile) -> ElementType {
-        if (n == 0) return ElementType{};
-        double pos = quantile * (n - 1);
-        int lower = floor(pos);
-        int upper = ceil(pos);
-        if (lower == upper) {
-            return sortedCol[lower];
-        } 
-        // se for um numero par de records calcula a media
-        else {
-            if (holds_alternative<int>(sortedCol[lower]) && holds_alternative<int>(sortedCol[upper])) {
-                double lowerVal = get<int>(sortedCol[lower]);
-                double upperVal = get<int>(sortedCol[upper]);
-                return static_cast<int>((upper - pos) * lowerVal + (pos - lower) * upperVal);
-            } else if (holds_alternative<float>(sortedCol[lower]) && holds_alternative<float>(sortedCol[upper])) {
-                float lowerVal = get<float>(sortedCol[lower]);
-                float upperVal = get<float>(sortedCol[upper]);
-                return static_cast<float>((upper - pos) * lowerVal + (pos - lower) * upperVal);
-            } else {
-                return sortedCol[lower];
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            KLLSketch& sketch = partials[t];
+            double value;
+            for (size_t i = start; i < end; ++i) {
+                if (numericValue(column[i], divisor, value)) sketch.update(value);
             }
-        }
-    };
-    // adiciona os quantis no df
-    for (double q : quantiles) {
-        string label;
-        if (q == 0.0) label = "min";
-        else if (q == 1.0) label = "max";
-        else if (q == 0.5) label = "median";
-        else label = "Q" + to_string(static_cast<int>(q * 100));
-        result[label] = getQuantileValue(q);
+        }));
     }
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    for (int t = 1; t < numThreads; ++t) partials[0].merge(partials[t]);
+    return move(partials[0]);
+}
 
+unordered_map<string, ElementType> sketch_quantiles(const KLLSketch& sketch, const vector<double>& quantiles, bool isInt) {
+    // Converte os quantis de um sketch para o formato de getQuantiles
+    unordered_map<string, ElementType> result;
+    vector<double> values = sketch.quantiles(quantiles);
+    for (size_t k = 0; k < quantiles.size(); ++k) {
+        string label = quantile_label(quantiles[k]);
+        if (sketch.empty()) result[label] = ElementType{};
+        else if (isInt) result[label] = static_cast<int>(values[k]);
+        else result[label] = static_cast<float>(values[k]);
+    }
     return result;
 }
 
-double calculateMeanParallel(const DataFrame& df, int id, int numThreads, const string& target_col, ThreadPool& pool) {
+unordered_map<string, ElementType> getQuantilesApprox(const DataFrameView& df, int id, int numThreads, const string& colName, const vector<double>& quantiles, ThreadPool& pool, int k) {
+    /*
+    Quantis aproximados por sketch KLL, no mesmo formato de getQuantiles. Faz uma única
+    leitura da coluna com memória O(k log n), sem copiar os valores; o erro de posição
+    é de cerca de 1,7 / k (mínimo e máximo são exatos).
+    */
+    bool isInt = df.getColumnType(df.getColumnIndex(colName)) == "int";
+    KLLSketch sketch = build_quantile_sketch(df, id, numThreads, colName, pool, k);
+    return sketch_quantiles(sketch, quantiles, isInt);
+}
+
+DataFrame groupby_quantiles(const DataFrameView& df, int id, int numThreads, const string& groupCol, const string& targetCol, const vector<double>& quantiles, ThreadPool& pool, int k) {
+    /*
+    Quantis aproximados de targetCol por grupo de groupCol (ex.: mediana do valor por
+    cidade). Cada thread mantém um sketch KLL por grupo, separado em partições pelo hash
+    como no groupby_mean, e os sketches de cada grupo são fundidos no final.
+    O resultado tem a coluna do grupo e uma coluna float por quantil (min, Q25, median...).
+    */
+    int groupIdx = df.getColumnIndex(groupCol);
+    const auto& groupVec = df.getColumn(groupIdx);
+    int targetIdx = df.getColumnIndex(targetCol);
+    const auto& targetVec = df.getColumn(targetIdx);
+    double divisor = numericDivisor(df.getColumnType(targetIdx));
+
+    vector<string> colNames = {groupCol};
+    vector<string> colTypes = {df.getColumnType(groupIdx)};
+    for (double q : quantiles) {
+        colNames.push_back(quantile_label(q) + "_" + targetCol);
+        colTypes.push_back("float");
+    }
+    DataFrameBuilder resultDf(colNames, colTypes);
+
+    int total_records = df.getNumRecords();
+    if (total_records == 0) return resultDf.finish();
+    numThreads = min(numThreads, total_records);
+    int block_size = (total_records + numThreads - 1) / numThreads;
+
+    using SketchMap = FlatHashMap<ElementType, KLLSketch>;
+    int numPartitions = merge_partition_count(numThreads);
+    vector<vector<SketchMap>> partials(numThreads);
+    vector<future<void>> futures;
+
+    for (int t = 0; t < numThreads; ++t) {
+        int start = t * block_size;
+        int end = min(start + block_size, total_records);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            size_t expected = estimate_distinct(groupVec, start, end) / numPartitions;
+            vector<SketchMap> local_maps(numPartitions);
+            for (auto& local_map : local_maps) local_map.reserve(expected);
+
+            for (int i = start; i < end; ++i) {
+                double value;
+                if (!numericValue(targetVec[i], divisor, value)) continue;
+
+                KLLSketch& sketch = local_maps[partition_of(groupVec[i], numPartitions)][groupVec[i]];
+                if (sketch.empty()) sketch = KLLSketch(k);
+                sketch.update(value);
+            }
+            partials[t] = move(local_maps);
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    vector<SketchMap> merged = merge_partitioned_maps(partials, numPartitions, id, pool,
+        [k](KLLSketch& acc, const KLLSketch& val) {
+            if (acc.empty()) acc = KLLSketch(k);
+            acc.merge(val);
+        });
+
+    fill_from_partitions(merged, resultDf, id, pool,
+        [&resultDf, &quantiles](const ElementType& key, const KLLSketch& sketch, size_t row) {
+            resultDf.column(0).set(row, key);
+            vector<double> values = sketch.quantiles(quantiles);
+            for (size_t q = 0; q < values.size(); ++q) {
+                resultDf.column(q + 1).set(row, static_cast<float>(values[q]));
+            }
+        });
+
+    return resultDf.finish();
+}
+
+double calculateMeanParallel(const DataFrameView& df, int id, int numThreads, const string& target_col, ThreadPool& pool) {
     // Obtém o índice da coluna de interesse
     int targetIdx = df.getColumnIndex(target_col);
-    const auto& targetVec = df.columns[targetIdx];
+    const auto& targetVec = df.getColumn(targetIdx);
 
     int totalRecords = df.getNumRecords();
     numThreads = min(numThreads, static_cast<int>(totalRecords));
     int blockSize = (totalRecords + numThreads - 1) / numThreads;
 
+    // Colunas decimal são somadas em centavos, de forma exata
+    bool isDecimal = df.getColumnType(targetIdx) == "decimal";
+
     // Cria promessas e futuros
-    vector<promise<pair<double, int>>> promises(numThreads);
-    vector<future<pair<double, int>>> futures;
+    vector<promise<tuple<double, long long, int>>> promises(numThreads);
+    vector<future<tuple<double, long long, int>>> futures;
 
     // Relacionamento entre promessas e futuros
     for (auto& p : promises) {
@@ -638,6 +2587,8 @@ double calculateMeanParallel(const DataFrame& df, int id, int numThreads, const
             double localSum = 0.0;
             int count = 0;
 
+            long long localCents = 0;
+
             for (int i = start; i < end; ++i) {
                 if (holds_alternative<int>(targetVec[i])) {
                     localSum += get<int>(targetVec[i]);
@@ -645,11 +2596,14 @@ double calculateMeanParallel(const DataFrame& df, int id, int numThreads, const
                 } else if (holds_alternative<float>(targetVec[i])) {
                     localSum += get<float>(targetVec[i]);
                     count++;
+                } else if (isDecimal && holds_alternative<long long>(targetVec[i])) {
+                    localCents += get<long long>(targetVec[i]);
+                    count++;
                 }
             }
 
             // Define o resultado local da thread
-            promises[t].set_value(make_pair(localSum, count));
+            promises[t].set_value(make_tuple(localSum, localCents, count));
         });
     }
 
@@ -657,72 +2611,289 @@ double calculateMeanParallel(const DataFrame& df, int id, int numThreads, const
 
     // Fusão dos resultados
     double totalSum = 0.0;
+    long long totalCents = 0;
     int totalCount = 0;
 
     for (auto& f : futures) {
-        auto result = f.get();
-        totalSum += result.first;
-        totalCount += result.second;
+        auto [sum, cents, count] = f.get();
+        totalSum += sum;
+        totalCents += cents;
+        totalCount += count;
     }
 
     // Calcula a média
+    if (isDecimal) totalSum += static_cast<double>(totalCents) / DECIMAL_SCALE;
     return totalCount > 0 ? totalSum / totalCount : 0.0;
 }
 
-DataFrame summaryStats(const DataFrame& df, int id, int numThreads, const string& colName, ThreadPool& pool) {
-    // Quantis que queremos calcular
-    vector<double> quantilesToCompute = {0.0, 0.25, 0.5, 0.75, 1.0};
-    unordered_map<string, ElementType> quantileResults = getQuantiles(df, id, numThreads, colName, quantilesToCompute, pool);
-    
-    for (auto& [label, val] : quantileResults) {
-        if (holds_alternative<int>(val)) {
-            val = static_cast<float>(get<int>(val));
+vector<ColumnSummary> summarize_columns(const DataFrameView& df, int id, int numThreads, const vector<string>& colNames, const vector<double>& quantiles, ThreadPool& pool, bool approximate) {
+    /*
+    Estatísticas de várias colunas numéricas em uma única leitura: cada thread percorre
+    o seu bloco de linhas uma vez para todas as colunas, acumulando contagem, soma,
+    variância (Welford), mínimo e máximo, e guardando os valores para os quantis exatos
+    (ou alimentando um sketch KLL, se approximate). Os blocos são combinados pela fórmula
+    de Chan para a variância. Valores não numéricos são contados como nulos.
+    Colunas decimal também somam os centavos em inteiros, para uma média exata; as demais
+    colunas long long (time, timestamp), cuja soma estouraria, usam a soma em double.
+    */
+    size_t numCols = colNames.size();
+    vector<ColumnRef> columns;
+    vector<double> divisors;
+    vector<bool> exactCents;
+    for (const string& name : colNames) {
+        int colIdx = df.getColumnIndex(name);
+        columns.push_back(df.getColumn(colIdx));
+        divisors.push_back(numericDivisor(df.getColumnType(colIdx)));
+        exactCents.push_back(df.getColumnType(colIdx) == "decimal");
+    }
+
+    // Acumuladores de um bloco de uma coluna
+    struct BlockStats {
+        size_t count = 0;
+        size_t nullCount = 0;
+        double sum = 0.0;
+        long long cents = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+        double min = numeric_limits<double>::infinity();
+        double max = -numeric_limits<double>::infinity();
+        vector<double> values;
+        KLLSketch sketch;
+    };
+
+    int totalRecords = df.getNumRecords();
+    numThreads = max(1, min(numThreads, totalRecords));
+    int blockSize = (totalRecords + numThreads - 1) / numThreads;
+
+    vector<vector<BlockStats>> partials(numThreads, vector<BlockStats>(numCols));
+    vector<future<void>> futures;
+
+    for (int t = 0; t < numThreads; ++t) {
+        int start = min(t * blockSize, totalRecords);
+        int end = min(start + blockSize, totalRecords);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            for (size_t c = 0; c < numCols; ++c) {
+                ColumnRef column = columns[c];
+                BlockStats& stats = partials[t][c];
+                if (!approximate) stats.values.reserve(end - start);
+
+                for (int i = start; i < end; ++i) {
+                    double x;
+                    const long long* wide = get_if<long long>(&column[i]);
+                    if (wide && exactCents[c]) {
+                        stats.cents += *wide;
+                        x = *wide / divisors[c];
+                    } else if (!numericValue(column[i], divisors[c], x)) {
+                        stats.nullCount++;
+                        continue;
+                    } else {
+                        stats.sum += x;
+                    }
+
+                    stats.count++;
+                    double delta = x - stats.mean;
+                    stats.mean += delta / stats.count;
+                    stats.m2 += delta * (x - stats.mean);
+                    if (x < stats.min) stats.min = x;
+                    if (x > stats.max) stats.max = x;
+
+                    if (approximate) stats.sketch.update(x);
+                    else stats.values.push_back(x);
+                }
+            }
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
+
+    // Fusão dos blocos, na ordem das linhas
+    vector<ColumnSummary> summaries(numCols);
+    for (size_t c = 0; c < numCols; ++c) {
+        ColumnSummary& summary = summaries[c];
+        summary.column = colNames[c];
+        summary.isInt = df.getColumnType(df.getColumnIndex(colNames[c])) == "int";
+
+        double sum = 0.0, mean = 0.0, m2 = 0.0;
+        long long cents = 0;
+        double minVal = numeric_limits<double>::infinity();
+        double maxVal = -numeric_limits<double>::infinity();
+        size_t count = 0;
+        for (int t = 0; t < numThreads; ++t) {
+            const BlockStats& block = partials[t][c];
+            summary.nullCount += block.nullCount;
+            if (block.count == 0) continue;
+
+            size_t merged = count + block.count;
+            double delta = block.mean - mean;
+            m2 += block.m2 + delta * delta * (static_cast<double>(count) * block.count / merged);
+            mean += delta * block.count / merged;
+            count = merged;
+            sum += block.sum;
+            cents += block.cents;
+            minVal = min(minVal, block.min);
+            maxVal = max(maxVal, block.max);
+        }
+
+        summary.count = count;
+        if (count == 0) {
+            summary.quantiles.assign(quantiles.size(), 0.0);
+            continue;
+        }
+        summary.mean = (sum + cents / divisors[c]) / count;
+        summary.variance = count > 1 ? m2 / (count - 1) : 0.0;
+        summary.min = minVal;
+        summary.max = maxVal;
+
+        if (approximate) {
+            for (int t = 1; t < numThreads; ++t) partials[0][c].sketch.merge(partials[t][c].sketch);
+            summary.quantiles = partials[0][c].sketch.quantiles(quantiles);
+        } else {
+            vector<vector<double>> blocks(numThreads);
+            for (int t = 0; t < numThreads; ++t) blocks[t] = move(partials[t][c].values);
+            vector<double> values = concat_blocks(blocks, id, pool);
+            summary.quantiles = exact_quantiles(values, quantiles, id, numThreads, pool);
         }
     }
 
-    // Calcula a média
-    double mean = calculateMeanParallel(df, id, numThreads, colName, pool);
+    return summaries;
+}
+
+DataFrame describe(const DataFrameView& df, int id, int numThreads, const vector<string>& colNames, ThreadPool& pool, bool approximate) {
+    /*
+    Tabela de estatísticas descritivas (como o describe do pandas) das colunas numéricas
+    pedidas, calculada por summarize_columns em uma única leitura dos dados.
+    Uma linha por estatística e uma coluna float por coluna analisada.
+    */
+    vector<double> quantilesToCompute = {0.25, 0.5, 0.75};
+    vector<ColumnSummary> summaries = summarize_columns(df, id, numThreads, colNames, quantilesToCompute, pool, approximate);
+
+    vector<string> resultNames = {"statistic"};
+    vector<string> resultTypes = {"string"};
+    for (const string& name : colNames) {
+        resultNames.push_back(name);
+        resultTypes.push_back("float");
+    }
+    DataFrameBuilder resultDf(resultNames, resultTypes);
+
+    vector<string> statistics = {"count", "null_count", "mean", "std", "min", "Q1", "median", "Q3", "max"};
+    for (const string& statistic : statistics) resultDf.column(0).push_back(statistic);
+
+    for (size_t c = 0; c < summaries.size(); ++c) {
+        const ColumnSummary& summary = summaries[c];
+        vector<double> values = {
+            static_cast<double>(summary.count), static_cast<double>(summary.nullCount),
+            summary.mean, sqrt(summary.variance), summary.min,
+            summary.quantiles[0], summary.quantiles[1], summary.quantiles[2], summary.max
+        };
+        ColumnBuilder& column = resultDf.column(c + 1);
+        for (double value : values) column.push_back(static_cast<float>(value));
+    }
+
+    return resultDf.finish();
+}
+
+DataFrame summaryStats(const DataFrameView& df, int id, int numThreads, const string& colName, ThreadPool& pool, bool approximate) {
+    // Quartis (exatos, ou aproximados por sketch se pedido); mínimo, máximo e média saem da mesma leitura
+    vector<double> quantilesToCompute = {0.25, 0.5, 0.75};
+    ColumnSummary summary = summarize_columns(df, id, numThreads, {colName}, quantilesToCompute, pool, approximate)[0];
+
+    // Colunas inteiras mantêm os quantis truncados, como em getQuantiles
+    vector<double> values = {summary.min, summary.quantiles[0], summary.quantiles[1], summary.quantiles[2], summary.max};
+    if (summary.isInt) {
+        for (double& value : values) value = static_cast<int>(value);
+    }
 
     // Monta os nomes e tipos do DataFrame de saída
     vector<string> colNames = {"statistic", "value"};
     vector<string> colTypes = {"string", "float"};
-    DataFrame summaryDf(colNames, colTypes);
+    DataFrameBuilder summaryDf(colNames, colTypes);
 
     // Adiciona os quantis no DataFrame
-    summaryDf.addRecord({"min", to_string(get<float>(quantileResults["min"]))});
-    summaryDf.addRecord({"Q1", to_string(get<float>(quantileResults["Q25"]))});
-    summaryDf.addRecord({"median", to_string(get<float>(quantileResults["median"]))});
-    summaryDf.addRecord({"Q3", to_string(get<float>(quantileResults["Q75"]))});
-    summaryDf.addRecord({"max", to_string(get<float>(quantileResults["max"]))});
+    vector<string> statistics = {"min", "Q1", "median", "Q3", "max"};
+    for (size_t i = 0; i < statistics.size(); ++i) {
+        summaryDf.column(0).push_back(statistics[i]);
+        summaryDf.column(1).push_back(static_cast<float>(values[i]));
+    }
 
     // Adiciona a média
-    summaryDf.addRecord({"mean", to_string(mean)});
+    summaryDf.column(0).push_back(string("mean"));
+    summaryDf.column(1).push_back(static_cast<float>(summary.mean));
 
-    return summaryDf;
+    return summaryDf.finish();
 }
 
-DataFrame top_10_cidades_transacoes(const DataFrame& df, int id, int numThreads, const string& colName, ThreadPool& pool) {
-    // Conta o número de transações por cidade
-    int numDays = 0;
-    DataFrame contagem = count_values(df, id, numThreads, colName, numDays, pool);
+DataFrame top_k(const DataFrameView& df, int id, int numThreads, const string& keyCol, size_t k, bool ascending, ThreadPool& pool) {
+    /*
+    Retorna as k linhas com os menores (ascending) ou maiores valores de keyCol, já
+    ordenadas, sem ordenar o DataFrame inteiro. Cada thread mantém um heap limitado a
+    k elementos sobre o seu bloco e os heaps parciais são fundidos no final.
+    Empates são resolvidos pela posição da linha, como na ordenação estável.
+    */
+    size_t n = df.getNumRecords();
+    k = min(k, n);
+    if (k == 0) return gather_rows(df, {}, id, numThreads, pool);
+    numThreads = min(numThreads, static_cast<int>(n));
+    size_t blockSize = (n + numThreads - 1) / numThreads;
 
-    // Ordena de forma decrescente pelo número de transações
-    DataFrame ordenado = sort_by_column_parallel(contagem, id, numThreads, contagem.getColumnName(1), pool, false);
+    // Códigos que preservam a ordem (numéricos ou de dicionário, já na direção pedida)
+    vector<uint32_t> codes = sort_codes(df.getColumn(df.getColumnIndex(keyCol)), keyCol, ascending, id, numThreads, pool);
 
-    // Monta os nomes e tipos do DataFrame de saída
-    vector<string> colNames = {"location", "num_trans"};
-    vector<string> colTypes = {"string", "int"};
-    DataFrame top10(colNames, colTypes);
+    // Heap de máximo com (código << 32 | linha): o topo é o pior dos k melhores
+    vector<vector<uint64_t>> partialHeaps(numThreads);
+    vector<future<void>> futures;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t start = min(t * blockSize, n);
+        size_t end = min(start + blockSize, n);
+
+        futures.push_back(pool.enqueue(-id, [&, start, end, t]() {
+            vector<uint64_t> heap;
+            heap.reserve(k);
+            for (size_t i = start; i < end; ++i) {
+                uint64_t entry = (static_cast<uint64_t>(codes[i]) << 32) | i;
+                if (heap.size() < k) {
+                    heap.push_back(entry);
+                    push_heap(heap.begin(), heap.end());
+                } else if (entry < heap.front()) {
+                    pop_heap(heap.begin(), heap.end());
+                    heap.back() = entry;
+                    push_heap(heap.begin(), heap.end());
+                }
+            }
+            partialHeaps[t] = move(heap);
+        }));
+    }
+
+    pool.isReady(-id);
+    for (auto& f : futures) f.get();
 
-    // Adiciona as 10 primeiras cidades no df
-    size_t max_records = 10;
-    for (size_t i = 0; i < max_records; ++i) {
-        vector<ElementType> record = ordenado.getRecord(i);
-        string cidade = std::get<string>(record[0]);
-        int num_trans = std::get<int>(record[1]);
+    // Fusão: no máximo k * numThreads candidatos
+    vector<uint64_t> candidates;
+    for (auto& heap : partialHeaps) {
+        candidates.insert(candidates.end(), heap.begin(), heap.end());
+    }
+    partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
 
-        top10.addRecord({cidade, to_string(num_trans)});
+    vector<size_t> rows(k);
+    for (size_t i = 0; i < k; ++i) {
+        rows[i] = static_cast<uint32_t>(candidates[i]);
     }
+
+    return gather_rows(df, rows, id, numThreads, pool);
+}
+
+DataFrame top_10_cidades_transacoes(const DataFrameView& df, int id, int numThreads, const string& colName, ThreadPool& pool) {
+    // Conta o número de transações por cidade
+    int numDays = 0;
+    DataFrame contagem = count_values(df, id, numThreads, colName, numDays, pool);
+
+    // As 10 cidades com mais transações
+    DataFrame top10 = top_k(contagem, id, numThreads, contagem.getColumnName(1), 10, false, pool);
+
+    // Nomes das colunas de saída
+    if (colName != "location") top10.changeColumnName(colName, "location");
+    top10.changeColumnName(contagem.getColumnName(1), "num_trans");
     
     return top10;
 }
@@ -748,21 +2919,30 @@ DataFrame abnormal_transactions(const DataFrame& dfTransac, const DataFrame& dfA
     int idxAccountAccount = dfAccount.getColumnIndex(accountColAccount);
     int idxLocationAccount = dfAccount.getColumnIndex(locationColAccount);
     
-    const vector<ElementType>& colTrans = dfTransac.getColumn(idxTrans);
-    const vector<ElementType>& colAmount = dfTransac.getColumn(idxAmount);
-    const vector<ElementType>& colLocationTransac = dfTransac.getColumn(idxLocation);
-    const vector<ElementType>& colAccountTransac = dfTransac.getColumn(idxAccountTransac);
-    const vector<ElementType>& colAccountAccount = dfAccount.getColumn(idxAccountAccount);
-    const vector<ElementType>& colLocationAccount = dfAccount.getColumn(idxLocationAccount);
+    const Column colTrans = dfTransac.getColumn(idxTrans);
+    const Column colAmount = dfTransac.getColumn(idxAmount);
+    const Column colLocationTransac = dfTransac.getColumn(idxLocation);
+    const Column colAccountTransac = dfTransac.getColumn(idxAccountTransac);
+    const Column colAccountAccount = dfAccount.getColumn(idxAccountAccount);
+    const Column colLocationAccount = dfAccount.getColumn(idxLocationAccount);
+    double amountDivisor = numericDivisor(dfTransac.getColumnType(idxAmount));
     
-    // Mapeando todos os ids de conta para as suas localizações
-    unordered_map<int, string> accountLocationMap;
-    for (int i = 0; i < dfAccount.getNumRecords(); i++) 
+    // Mapeando todos os ids de conta para as suas localizações.
+    // Se os ids forem densos, a busca é um acesso direto a um vetor indexado por (id - mínimo).
+    DenseKeyRange accountRange = dense_key_range(colAccountAccount, id, numThreads, pool);
+    vector<const string*> accountLocationVec(accountRange.size(), nullptr);
+    FlatHashMap<int, const string*> accountLocationMap;
+    int numAccounts = dfAccount.getNumRecords();
+    if (!accountRange.dense) accountLocationMap.reserve(numAccounts);
+    for (int i = 0; i < numAccounts; i++) 
     {
 
-        int id = get<int>(colAccountAccount[i]);
-        string loc = get<string>(colLocationAccount[i]);
-        accountLocationMap[id] = loc;
+        int accountID = get<int>(colAccountAccount[i]);
+        const string& loc = get<string>(colLocationAccount[i]);
+        if (accountRange.dense)
+            accountLocationVec[accountID - accountRange.minKey] = &loc;
+        else
+            accountLocationMap[accountID] = &loc;
     }
 
     vector<shared_ptr<promise<tuple<vector<ElementType>, vector<ElementType>, vector<ElementType>>>>> promises(numThreads);
@@ -777,26 +2957,36 @@ DataFrame abnormal_transactions(const DataFrame& dfTransac, const DataFrame& dfA
         promises[t] = make_shared<promise<tuple<vector<ElementType>, vector<ElementType>, vector<ElementType>>>>();
         futures.push_back(promises[t]->get_future());
         
-        pool.enqueue(-id, [start, end, lower, upper,
+        pool.enqueue(-id, [start, end, lower, upper, amountDivisor,
                     &colTrans, &colAmount, &colLocationTransac, &colAccountTransac, 
-                    &colAccountAccount, &colLocationAccount, &accountLocationMap, p = promises[t]]() {
+                    &colAccountAccount, &colLocationAccount, &accountLocationMap, &accountLocationVec, &accountRange, p = promises[t]]() {
             vector<ElementType> ids;
             vector<ElementType> suspiciousLocation;
             vector<ElementType> suspiciousAmount;
 
             for (size_t i = start; i < end; i++) 
             {
-                float amount = get<float>(colAmount[i]);
-                string locationTransac = get<string>(colLocationTransac[i]);
+                // Valores em float ou decimal; a comparação com os limites continua em float
+                double amountValue = 0.0;
+                numericValue(colAmount[i], amountDivisor, amountValue);
+                float amount = static_cast<float>(amountValue);
+                const string& locationTransac = get<string>(colLocationTransac[i]);
                 int id = get<int>(colTrans[i]);
                 int accountIDTransac = get<int>(colAccountTransac[i]);
                 
                 // Pegando a localização da conta em account
-                auto it = accountLocationMap.find(accountIDTransac);
-                string locationAccount = it->second;
+                const string* locationAccount = nullptr;
+                if (accountRange.dense) {
+                    if (accountIDTransac >= accountRange.minKey && accountIDTransac <= accountRange.maxKey)
+                        locationAccount = accountLocationVec[accountIDTransac - accountRange.minKey];
+                } else {
+                    const string* const* it = accountLocationMap.find(accountIDTransac);
+                    if (it)
+                        locationAccount = *it;
+                }
 
                 bool isAmountSus = (amount < lower || amount > upper);
-                bool isLocationSus = (locationTransac != locationAccount);
+                bool isLocationSus = (locationAccount == nullptr || locationTransac != *locationAccount);
                 if (isAmountSus || isLocationSus) {
                     ids.push_back(id);
                     suspiciousLocation.push_back(isLocationSus);
@@ -810,27 +3000,22 @@ DataFrame abnormal_transactions(const DataFrame& dfTransac, const DataFrame& dfA
 
     pool.isReady(-id);
 
-    // Juntando resultados das threads
-    vector<ElementType> ids, suspiciousLocation, suspiciousAmount;
-    for (auto& fut : futures)
-    {
-        auto [localIds, localLoc, localAmt] = fut.get();
-        ids.insert(ids.end(), localIds.begin(), localIds.end());
-        suspiciousLocation.insert(suspiciousLocation.end(), localLoc.begin(), localLoc.end());
-        suspiciousAmount.insert(suspiciousAmount.end(), localAmt.begin(), localAmt.end());
-    }
-
     // Monta o DataFrame
     string typeColumn = dfTransac.getColumnType(idxTrans);
     vector<string> colNames = {transactionIDCol, "is_location_suspicious", "is_amount_suspicious"};
     vector<string> colTypes = {typeColumn, "bool", "bool"};
+    DataFrameBuilder result(colNames, colTypes);
 
-    DataFrame result(colNames, colTypes);
-    result.addColumn(ids, transactionIDCol, typeColumn);
-    result.addColumn(suspiciousLocation, "is_location_suspicious", "bool");
-    result.addColumn(suspiciousAmount, "is_amount_suspicious", "bool");
+    // Juntando resultados das threads, na ordem dos blocos
+    for (auto& fut : futures)
+    {
+        auto [localIds, localLoc, localAmt] = fut.get();
+        result.column(0).append(move(localIds));
+        result.column(1).append(move(localLoc));
+        result.column(2).append(move(localAmt));
+    }
 
-    return result;
+    return result.finish();
 }
 
 
@@ -0,0 +1,280 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include "../include/df.h"
+#include "../include/df_builder.h"
+#include "../include/datetime.h"
+#include "../include/predicate.h"
+#include "../include/snapshot.h"
+#include "../include/arrow_ipc.h"
+#include "../include/tratadores.h"
+#include "../include/threads.h"
+
+const int NUM_THREADS = 4;
+
+using namespace std;
+
+int failures = 0;
+
+void check(bool condition, const string& description)
+{
+    if (!condition)
+    {
+        cout << "  FALHOU: " << description << endl;
+        failures++;
+    }
+}
+
+DataFrame sampleFrame()
+{
+    // Uma coluna de cada tipo, mais uma coluna string com valores de vários tipos
+    DataFrameBuilder builder({"i", "f", "b", "s", "d", "t", "ts", "dec", "mixed"},
+                             {"int", "float", "bool", "string", "date", "time", "timestamp", "decimal", "string"});
+    for (int r = 0; r < 1000; r++)
+    {
+        builder.column(0).push_back(r * 7 - 3000);
+        builder.column(1).push_back(r * 0.25f);
+        builder.column(2).push_back(r % 3 == 0);
+        builder.column(3).push_back(string(r % 5 == 0 ? "Rio \"de\" Janeiro" : "Recife, PE"));
+        builder.column(4).push_back(r * 40 - 20000);
+        builder.column(5).push_back(static_cast<long long>(r) * 86399999LL);
+        builder.column(6).push_back(static_cast<long long>(r - 500) * 3600000001LL);
+        builder.column(7).push_back(static_cast<long long>(r) * 12345 - 6000000);
+        if (r % 2 == 0) builder.column(8).push_back(r);
+        else builder.column(8).push_back(string("x") + to_string(r));
+    }
+    return builder.finish();
+}
+
+bool sameSchema(const DataFrame& a, const DataFrame& b)
+{
+    return a.getNumRecords() == b.getNumRecords() && a.getColumnNames() == b.getColumnNames() &&
+           a.getColumnTypes() == b.getColumnTypes();
+}
+
+void testSnapshot()
+{
+    cout << "Snapshot: ida e volta..." << endl;
+    DataFrame df = sampleFrame();
+    DataFrame empty({"a", "b"}, {"int", "decimal"});
+
+    for (const DataFrame* original : {&df, &empty})
+    {
+        string path = "output/format_test.dfsnap";
+        check(writeSnapshot(*original, path), "escrita do snapshot");
+        DataFrame* read = readSnapshot(path);
+        remove(path.c_str());
+        check(read != nullptr, "leitura do snapshot");
+        if (!read) continue;
+
+        check(sameSchema(*original, *read), "esquema do snapshot");
+        for (int j = 0; j < original->getNumCols() && sameSchema(*original, *read); j++)
+        {
+            for (int r = 0; r < original->getNumRecords(); r++)
+            {
+                if (original->getColumn(j)[r] != read->getColumn(j)[r])
+                {
+                    check(false, "valor da coluna " + original->getColumnName(j) + " no snapshot");
+                    break;
+                }
+            }
+        }
+        delete read;
+    }
+}
+
+void testArrow()
+{
+    cout << "Arrow: ida e volta..." << endl;
+    DataFrame df = sampleFrame();
+    DataFrame empty({"a", "b"}, {"int", "decimal"});
+
+    for (const DataFrame* original : {&df, &empty})
+    {
+        string path = "output/format_test.arrow";
+        check(writeArrow(*original, path), "escrita do Arrow");
+        DataFrame* read = readArrow(path);
+        remove(path.c_str());
+        check(read != nullptr, "leitura do Arrow");
+        if (!read) continue;
+
+        check(sameSchema(*original, *read), "esquema do Arrow");
+        for (int j = 0; j < original->getNumCols() && sameSchema(*original, *read); j++)
+        {
+            // A coluna com vários tipos volta como texto, formatado como no CSV
+            bool mixed = original->getColumnName(j) == "mixed";
+            for (int r = 0; r < original->getNumRecords(); r++)
+            {
+                const ElementType& value = original->getColumn(j)[r];
+                bool same = mixed ? variantToString(value) == get<string>(read->getColumn(j)[r])
+                                  : value == read->getColumn(j)[r];
+                if (!same)
+                {
+                    check(false, "valor da coluna " + original->getColumnName(j) + " no Arrow");
+                    break;
+                }
+            }
+        }
+        delete read;
+    }
+}
+
+void testParsing()
+{
+    cout << "Leitura de decimais e datas..." << endl;
+    long long cents = 0;
+    check(parseDecimal("12.34", cents) && cents == 1234, "decimal 12.34");
+    check(parseDecimal("-0.5", cents) && cents == -50, "decimal -0.5");
+    check(parseDecimal("1.005", cents) && cents == 101, "arredondamento da terceira casa");
+    check(parseDecimal("9999999999999999.99", cents) && cents == 999999999999999999LL, "maior decimal aceito");
+    check(parseDecimal("0000000000000000000001.00", cents) && cents == 100, "zeros à esquerda não contam");
+    check(!parseDecimal("99999999999999999", cents), "parte inteira com 17 dígitos");
+    check(!parseDecimal("", cents), "decimal vazio");
+    check(!parseDecimal("1.2.3", cents), "decimal com dois pontos");
+    check(!parseDecimal("12a", cents), "decimal com texto");
+
+    int64_t days = 0;
+    check(parse_date("1970-01-01", days) && days == 0, "data 1970-01-01");
+    check(parse_date("2024-02-29", days) && format_date(days) == "2024-02-29", "29 de fevereiro em ano bissexto");
+    check(parse_date("2000-02-29", days), "2000 é bissexto");
+    check(!parse_date("1900-02-29", days), "1900 não é bissexto");
+    check(!parse_date("2023-02-29", days), "29 de fevereiro em ano comum");
+    check(!parse_date("2024-02-31", days), "31 de fevereiro");
+    check(!parse_date("2024-04-31", days), "31 de abril");
+    check(!parse_date("2024-13-01", days), "mês 13");
+    check(!parse_date("2024-01-01 garbage", days), "data com texto depois");
+
+    long long micros = 0;
+    check(parse_timestamp("2024-01-01 10:00:00", micros) && format_timestamp(micros) == "2024-01-01 10:00:00.000000", "timestamp");
+    check(parse_timestamp("2024-01-01T10:00:00.5", micros), "timestamp com T e fração");
+    check(!parse_timestamp("2024-02-30 10:00:00", micros), "timestamp com dia inválido");
+}
+
+void testPredicateNot(ThreadPool& pool)
+{
+    cout << "Predicados com NOT..." << endl;
+    DataFrameBuilder builder({"v", "n"}, {"float", "int"});
+    builder.column(0).push_back(1.0f);
+    builder.column(0).push_back(2.0f);
+    builder.column(0).push_back(string("x"));
+    builder.column(1).push_back(1);
+    builder.column(1).push_back(string("y"));
+    builder.column(1).push_back(3);
+    DataFrame df = builder.finish();
+
+    using P = Predicate;
+    check(select_rows(df, 1, NUM_THREADS, P::compare("v", P::GT, 1.5), pool) == vector<size_t>{1}, "v > 1.5");
+    check(select_rows(df, 1, NUM_THREADS, !P::compare("v", P::GT, 1.5), pool) == vector<size_t>{0}, "NOT deixa de fora o valor não comparável");
+    check(select_rows(df, 1, NUM_THREADS, !!P::compare("v", P::GT, 1.5), pool) == vector<size_t>{1}, "NOT NOT");
+    check(select_rows(df, 1, NUM_THREADS, !P::compare("v", P::GT, 1.5) || P::compare("n", P::EQ, 3), pool) == vector<size_t>{0, 2}, "NOT com OR");
+    check(select_rows(df, 1, NUM_THREADS, !P::compare("n", P::EQ, 2.5), pool) == vector<size_t>{0, 2}, "NOT de literal que não ocorre na coluna");
+}
+
+void testGroupbyMean(ThreadPool& pool)
+{
+    cout << "groupby_mean denso e com hash..." << endl;
+    // Chaves pequenas usam o caminho denso; as mesmas chaves multiplicadas, o de hash
+    vector<DataFrame> results;
+    for (int scale : {1, 100000000})
+    {
+        DataFrameBuilder builder({"g", "v"}, {"int", "float"});
+        for (int r = 0; r < 10000; r++)
+        {
+            int key = r % 10;
+            builder.column(0).push_back(key * scale);
+            // O grupo 4 só tem valores não numéricos
+            if (key == 4) builder.column(1).push_back(string("n/a"));
+            else builder.column(1).push_back(static_cast<float>(r % 7));
+        }
+        DataFrame df = builder.finish();
+        DataFrame result = groupby_mean(df, 2, NUM_THREADS, "g", "v", pool);
+        results.push_back(sort_by_column_parallel(result, 2, NUM_THREADS, "g", pool, true));
+    }
+
+    check(results[0].getNumRecords() == 9 && results[1].getNumRecords() == 9, "grupo sem valores numéricos fica fora nos dois caminhos");
+    for (int r = 0; r < min(results[0].getNumRecords(), results[1].getNumRecords()); r++)
+    {
+        float dense = get<float>(results[0].getColumn(1)[r]);
+        float hashed = get<float>(results[1].getColumn(1)[r]);
+        check(get<int>(results[0].getColumn(0)[r]) * 100000000 == get<int>(results[1].getColumn(0)[r]), "mesmos grupos");
+        check(fabs(dense - hashed) < 1e-4, "mesma média nos dois caminhos");
+    }
+
+    DataFrame empty({"g", "v"}, {"int", "float"});
+    check(groupby_mean(empty, 2, NUM_THREADS, "g", "v", pool).getNumRecords() == 0, "groupby_mean de DataFrame vazio");
+    check(count_values(empty, 2, NUM_THREADS, "g", 0, pool).getNumRecords() == 0, "count_values de DataFrame vazio");
+}
+
+void testMixedSort(ThreadPool& pool)
+{
+    cout << "Ordenação com tipos misturados..." << endl;
+    DataFrameBuilder builder({"k"}, {"int"});
+    for (int value : {100, 20, 3, 5}) builder.column(0).push_back(value);
+    DataFrame ints = builder.finish();
+    DataFrame sorted = sort_by_column_parallel(ints, 3, NUM_THREADS, "k", pool, true);
+    check(get<int>(sorted.getColumn(0)[0]) == 3 && get<int>(sorted.getColumn(0)[3]) == 100, "ordenação numérica de int");
+
+    builder = DataFrameBuilder({"k"}, {"int"});
+    for (int value : {100, 20, 3, 5}) builder.column(0).push_back(value);
+    builder.column(0).push_back(7LL);
+    DataFrame mixed = builder.finish();
+
+    bool threw = false;
+    try { sort_by_column_parallel(mixed, 3, NUM_THREADS, "k", pool, true); }
+    catch (const invalid_argument&) { threw = true; }
+    check(threw, "sort_by_column_parallel rejeita int com long long");
+
+    threw = false;
+    try { top_k(mixed, 3, NUM_THREADS, "k", 2, true, pool); }
+    catch (const invalid_argument&) { threw = true; }
+    check(threw, "top_k rejeita int com long long");
+}
+
+void testSketches(ThreadPool& pool)
+{
+    cout << "Erro do HyperLogLog e do KLL..." << endl;
+    const int n = 200000;
+    DataFrameBuilder builder({"id", "x"}, {"int", "float"});
+    for (int r = 0; r < n; r++)
+    {
+        builder.column(0).push_back(static_cast<int>((r * 2654435761u) % 1000003));
+        builder.column(1).push_back(static_cast<float>((r * 7919) % n));
+    }
+    DataFrame df = builder.finish();
+
+    // Erro padrão do HLL ~1,6%: 5% fica acima de 3 desvios
+    double exact = count_distinct(df, 4, NUM_THREADS, "id", pool, false);
+    double approx = count_distinct(df, 4, NUM_THREADS, "id", pool, true);
+    check(fabs(approx - exact) / exact < 0.05, "HyperLogLog dentro de 5%");
+
+    // x é uma permutação de 0..n-1: o quantil q deve estar perto da posição q * n
+    KLLSketch sketch = build_quantile_sketch(df, 4, NUM_THREADS, "x", pool);
+    for (double q : {0.01, 0.25, 0.5, 0.75, 0.99})
+    {
+        double rankError = fabs(sketch.quantile(q) - q * n) / n;
+        check(rankError < 0.02, "KLL dentro de 2% no quantil " + to_string(q));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ThreadPool pool(NUM_THREADS);
+
+    testSnapshot();
+    testArrow();
+    testParsing();
+    testPredicateNot(pool);
+    testGroupbyMean(pool);
+    testMixedSort(pool);
+    testSketches(pool);
+
+    if (failures > 0)
+    {
+        cout << failures << " verificações falharam." << endl;
+        return 1;
+    }
+    cout << "Todas as verificações passaram." << endl;
+    return 0;
+}